@@ -0,0 +1,106 @@
+#pragma once
+
+#include <stdint.h>
+
+/***************************************************************************************/
+/* Beam racing for single buffered output.
+ *
+ * Without a back buffer every row pair (scan slot) is rewritten in place while the DMA engine keeps
+ * looping over the same memory, so a redraw that isn't aware of the scan position will show part of the
+ * new frame and part of the old one in the same refresh - i.e. a tear.
+ *
+ * The scheduler below decides when each scan slot may be rewritten. It works on a monotonic count of
+ * rows the DMA engine has finished (one EOF per row pair, see Bus_Parallel16::get_rows_scanned()), so
+ * the same logic runs on the device and in the host simulation under /testing.
+ *
+ * The new frame is made to appear from the top (slot 0) of the next full refresh, exactly as a flip of
+ * a double buffer would. The encoder sleeps until the scanner is BEAM_RACE_GUARD_ROWS rows short of the
+ * end of the current refresh, then writes slot 0, 1, 2... ahead of it. Each slot has to be written after
+ * the scanner has finished with it in the current refresh, and before it comes back round to it.
+ *
+ * Encoding a row pair is far quicker than scanning one out (~80us vs ~500us for a 256px chain at 8 bits)
+ * so in practice the encoder pulls away from the scanner and never has to wait once it has started.
+ */
+
+// Rows left between the scanner and the row being written, to cover the DMA prefetching the next row.
+#ifndef BEAM_RACE_GUARD_ROWS
+#define BEAM_RACE_GUARD_ROWS 2
+#endif
+
+#if BEAM_RACE_GUARD_ROWS < 1
+#error "BEAM_RACE_GUARD_ROWS must be at least 1"
+#endif
+
+class BeamRaceScheduler
+{
+public:
+  enum action_t
+  {
+    ROW_WAIT = 0,  // scanner is (or is about to be) on this slot, poll again
+    ROW_WRITE,     // safe to write, the new frame will appear on the next visit
+    ROW_WRITE_LATE // scanner has overtaken the encoder, this refresh will tear regardless
+  };
+
+  BeamRaceScheduler(uint16_t _rows) : rows(_rows) {}
+
+  /**
+   * @brief - start a new frame
+   * @param rows_scanned - scanner position, i.e. rows completed by the DMA engine so far
+   */
+  void begin(uint32_t rows_scanned)
+  {
+    // First refresh whose slot 0 we can still get ahead of
+    first = ((rows_scanned + BEAM_RACE_GUARD_ROWS - 1) / rows + 1) * rows;
+    written = 0;
+    late_rows = 0;
+  }
+
+  /** @brief - scanner position (rows_scanned) to wait for before writing the first row */
+  uint32_t startAt() const { return first - BEAM_RACE_GUARD_ROWS; }
+
+  bool done() const { return written >= rows; }
+
+  /** @brief - scan slot (row pair index) to be written next */
+  uint16_t nextRow() const { return written; }
+
+  /**
+   * @brief - can nextRow() be written with the scanner at the given position?
+   * @param rows_scanned - rows completed by the DMA engine, the scanner is currently outputting this (absolute) row
+   */
+  action_t poll(uint32_t rows_scanned) const
+  {
+    uint32_t target = first + written;               // absolute row at which this slot should first show the new frame
+    int32_t lead = (int32_t)(target - rows_scanned); // rows until the scanner gets there
+
+    // Still to pass (or still on) the previous visit of this slot, which has to show the old frame
+    if (lead >= rows)
+      return ROW_WAIT;
+
+    if (lead >= BEAM_RACE_GUARD_ROWS)
+      return ROW_WRITE;
+
+    // Too late to beat the scanner. Don't write under it though, let it move off (or go past) the slot first.
+    int32_t lead_this_pass = ((lead % rows) + rows) % rows;
+    if (lead_this_pass < BEAM_RACE_GUARD_ROWS)
+      return ROW_WAIT;
+
+    return ROW_WRITE_LATE;
+  }
+
+  /** @brief - nextRow() has been written, move on */
+  void rowWritten(bool late)
+  {
+    written++;
+    if (late)
+      late_rows++;
+  }
+
+  /** @brief - rows of the current frame that were written after the scanner had already reached them */
+  uint16_t lateRows() const { return late_rows; }
+
+private:
+  uint16_t rows;
+  uint32_t first = 0; // absolute row at which slot 0 shows the new frame
+  uint16_t written = 0;
+  uint16_t late_rows = 0;
+};
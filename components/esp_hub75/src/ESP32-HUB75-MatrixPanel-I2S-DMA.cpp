@@ -1,4 +1,7 @@
 #include "ESP32-HUB75-MatrixPanel-I2S-DMA.h"
+#include "ESP32-HUB75-MatrixPanel-BeamRace.hpp"
+#include "esp_rom_sys.h"
+#include "esp_timer.h"
 
 #if defined(SPIRAM_DMA_BUFFER)
 // Sprite_TM saves the day again...
@@ -80,6 +83,34 @@
     blue_val = blue_val > max_val ? max_val : blue_val;                                              
 #endif
 
+#if defined(TEMPORAL_DITHER)
+  #if defined(PIXEL_COLOR_DEPTH_BITS) && PIXEL_COLOR_DEPTH_BITS > 10
+    #error "TEMPORAL_DITHER needs two bits of headroom below the 12-bit LUT, use a PIXEL_COLOR_DEPTH_BITS of 10 or less"
+  #endif
+
+  /* 2x2 ordered dither threshold for each phase, [phase][y & 1][x & 1]. Phase 1 is phase 0 inverted, so a pixel
+   * that is rounded up in one phase is rounded down in the other: a quarter step lights one pixel in four in each
+   * phase, a half step lights every pixel in one of the two phases, and so on. */
+  static const uint8_t dither_threshold[2][2][2] = { { {0, 2}, {3, 1} }, { {3, 1}, {0, 2} } };
+
+  // Output level with two extra bits (quarter steps) of precision
+  #ifndef NO_CIE1931
+    #define DITHER_LEVEL(v) (lumConvTab_12bit[v] >> (10 - m_cfg.getPixelColorDepthBits()))
+  #else
+    #define DITHER_LEVEL(v) (((v) * ((4u << m_cfg.getPixelColorDepthBits()) - 1) + 127) / 255)
+  #endif
+
+  // As DO_BRIGHTNESS_COMPENSATION(), but the quarter steps round up when they're above the pixel's threshold
+  #define DO_DITHERED_COMPENSATION(threshold)                                                        \
+    uint16_t max_val = (1 << m_cfg.getPixelColorDepthBits()) - 1;                                    \
+    uint16_t red_q   = DITHER_LEVEL(red);                                                            \
+    uint16_t green_q = DITHER_LEVEL(green);                                                          \
+    uint16_t blue_q  = DITHER_LEVEL(blue);                                                           \
+    uint16_t red_val   = std::min<uint16_t>((red_q >> 2) + ((red_q & 3) > (threshold)), max_val);     \
+    uint16_t green_val = std::min<uint16_t>((green_q >> 2) + ((green_q & 3) > (threshold)), max_val); \
+    uint16_t blue_val  = std::min<uint16_t>((blue_q >> 2) + ((blue_q & 3) > (threshold)), max_val);
+#endif
+
 
 
 
@@ -105,6 +136,37 @@ bool MatrixPanel_I2S_DMA::setupDMA(const HUB75_I2S_CFG &_cfg)
   ESP_LOGI("I2S-DMA", "Free heap: %d", heap_caps_get_free_size(MALLOC_CAP_INTERNAL));
   ESP_LOGI("I2S-DMA", "Free SPIRAM: %d", heap_caps_get_free_size(MALLOC_CAP_SPIRAM));
 
+  if (m_cfg.source == HUB75_I2S_CFG::SOURCE_RGB565)
+  {
+#ifndef NO_CIE1931
+    const bool cie = true;
+#else
+    const bool cie = false;
+#endif
+    uint8_t depth = m_cfg.getPixelColorDepthBits();
+    uint8_t source_depth = RGB565SourceLUT::sourceDepthBits(depth, cie);
+
+    ESP_LOGI("I2S-DMA", "RGB565 source: %d of 32 red/blue and %d of 64 green levels shown at %d bits, %d bits show the same.", RGB565SourceLUT::distinctLevels(5, depth, cie), RGB565SourceLUT::distinctLevels(6, depth, cie), depth, source_depth);
+
+#if defined(NO_CIE1931) || !LUT_NATIVE_BIT_DEPTH
+    if (source_depth < depth)
+    {
+      ESP_LOGI("I2S-DMA", "RGB565 source: colour depth cut to %d bits, saving %d bytes of DMA framebuffer.", source_depth,
+                  (depth - source_depth) * PIXELS_PER_ROW * ROWS_PER_FRAME * (int)sizeof(ESP32_I2S_DMA_STORAGE_TYPE) * ((m_cfg.double_buff) ? 2 : 1));
+      m_cfg.setPixelColorDepthBits(source_depth);
+      MASK_OFFSET = 16 - m_cfg.getPixelColorDepthBits();
+    }
+#else
+    // The native CIE table is fixed to PIXEL_COLOR_DEPTH_BITS at compile time, so the depth can't be changed here
+    if (source_depth < depth)
+    {
+      ESP_LOGW("I2S-DMA", "RGB565 source: build with PIXEL_COLOR_DEPTH_BITS=%d to save memory.", source_depth);
+    }
+#endif
+
+    source_lut.build(m_cfg.getPixelColorDepthBits(), cie);
+  }
+
   size_t allocated_fb_memory = 0;
 
   int fbs_required = (m_cfg.double_buff) ? 2 : 1;
@@ -157,7 +219,7 @@ bool MatrixPanel_I2S_DMA::setupDMA(const HUB75_I2S_CFG &_cfg)
     // Now add the time for the remaining bit depths
     for (int i = lsbMsbTransitionBit + 1; i < m_cfg.getPixelColorDepthBits(); i++) {
       //nsPerRow += (1 << (i - lsbMsbTransitionBit - 1)) * (m_cfg.getPixelColorDepthBits() - i) * nsPerLatch;
-	  nsPerRow += (1 << (i - lsbMsbTransitionBit - 1)) *  nsPerLatch;
+	  nsPerRow += bcmExtraPasses(i) *  nsPerLatch;
 	}
 
     int nsPerFrame = nsPerRow * ROWS_PER_FRAME;
@@ -169,13 +231,25 @@ bool MatrixPanel_I2S_DMA::setupDMA(const HUB75_I2S_CFG &_cfg)
     if (actualRefreshRate >= m_cfg.min_refresh_rate)
       break;
 
+    // OE weighting halves the LSB's OE window with every step, it has to stay at least a pixel wide
+    if (m_cfg.modulation == HUB75_I2S_CFG::BCM_OE_WEIGHTED && ((PIXELS_PER_ROW - m_cfg.latch_blanking) >> (lsbMsbTransitionBit + 2)) < 1)
+    {
+      ESP_LOGW("I2S-DMA", "OE weighted LSB window can't be made any shorter than %d pixels.", (PIXELS_PER_ROW - m_cfg.latch_blanking) >> (lsbMsbTransitionBit + 1));
+      break;
+    }
+
     if (lsbMsbTransitionBit < m_cfg.getPixelColorDepthBits() - 1)
       lsbMsbTransitionBit++;
     else
       break;
   }
 
-  if (lsbMsbTransitionBit > 0)
+  if (m_cfg.modulation == HUB75_I2S_CFG::BCM_OE_WEIGHTED)
+  {
+    ESP_LOGI("I2S-DMA", "OE weighted BCM: bitplanes 0-%d weighted by OE window, %d row payloads per row.", lsbMsbTransitionBit,
+                lsbMsbTransitionBit + (1 << (m_cfg.getPixelColorDepthBits() - lsbMsbTransitionBit - 1)));
+  }
+  else if (lsbMsbTransitionBit > 0)
   {
     ESP_LOGW("I2S-DMA", "lsbMsbTransitionBit of %d used to achieve refresh rate of %d Hz. Percieved colour depth to the eye may be reduced.", lsbMsbTransitionBit, m_cfg.min_refresh_rate);
   }
@@ -209,7 +283,7 @@ bool MatrixPanel_I2S_DMA::setupDMA(const HUB75_I2S_CFG &_cfg)
 
   // Add descriptors for MSB bits after transition
   for (int i = lsbMsbTransitionBit + 1; i < m_cfg.getPixelColorDepthBits(); i++) {
-    dma_descriptors_per_row += (1 << (i - lsbMsbTransitionBit - 1)) * dma_descs_per_row_1cdepth;
+    dma_descriptors_per_row += bcmExtraPasses(i) * dma_descs_per_row_1cdepth;
   }
   
   //dma_descriptors_per_row = 1;
@@ -219,6 +293,8 @@ bool MatrixPanel_I2S_DMA::setupDMA(const HUB75_I2S_CFG &_cfg)
   
   ESP_LOGV("I2S-DMA", "DMA descriptors per row: %d", dma_descriptors_per_row);  
   ESP_LOGV("I2S-DMA", "DMA descriptors required per buffer: %d", dma_descriptions_required);    
+  ESP_LOGI("I2S-DMA", "%d DMA descriptors (%d bytes) per buffer, %d Hz refresh rate.", dma_descriptions_required,
+              dma_descriptions_required * (int)sizeof(HUB75_DMA_DESCRIPTOR_T), calculated_refresh_rate);
 
   /***
    * Step 3:  Allocate the DMA descriptor memory via. the relevant platform DMA implementation class.
@@ -228,6 +304,9 @@ bool MatrixPanel_I2S_DMA::setupDMA(const HUB75_I2S_CFG &_cfg)
     dma_bus.enable_double_dma_desc();
   }
 
+  // EOF at the end of every row so the scan position is known (used by drawFrameRGB565)
+  dma_bus.enable_row_eof(dma_descriptors_per_row);
+
   if ( !dma_bus.allocate_dma_desc_memory(dma_descriptions_required) )
   {
     return false;
@@ -238,14 +317,58 @@ bool MatrixPanel_I2S_DMA::setupDMA(const HUB75_I2S_CFG &_cfg)
    * Step 4:  Link up the DMA descriptors per the colour depth and rows.
    */
 
+  setupScanOrder();
+
+  // Bitplane repeats sent after the all colour depths payload, the same for every row.
+  // binary time division setup: we need 2 of bit (LSBMSB_TRANSITION_BIT + 1) four of (LSBMSB_TRANSITION_BIT + 2), etc
+  // because we sweep through to MSB each time, it divides the number of times we have to sweep in half (saving linked list RAM)
+  // we need 2^(i - LSBMSB_TRANSITION_BIT - 1) == 1 << (i - LSBMSB_TRANSITION_BIT - 1) passes from i to MSB
+  std::vector<uint8_t> repeat_planes;
+  bool repeats_full_oe = true;
+
+  for (int i = lsbMsbTransitionBit + 1; i < m_cfg.getPixelColorDepthBits(); i++) 
+  {
+    for (int k = 0; k < bcmExtraPasses(i); k++)
+      repeat_planes.push_back(i);
+
+    repeats_full_oe = repeats_full_oe && (bcmExtraPasses(i) == 0 || bcmOeShift(i) == 0);
+  }
+
+  // Every payload lights the plane latched by the one before it, so the repeats can only be shuffled if they all
+  // have the same (full) OE window - then each plane is still lit as many times as it's repeated.
+  if (m_cfg.row_scan_order == HUB75_I2S_CFG::SCAN_SCRAMBLED && repeats_full_oe)
+  {
+    // Spread each plane's repeats evenly over the sequence, i.e. 7 6 7 5 7 6 7 rather than 5 6 6 7 7 7 7
+    std::stable_sort(repeat_planes.begin(), repeat_planes.end(), [](uint8_t a, uint8_t b) { return a < b; });
+
+    std::vector<std::pair<uint32_t, uint8_t>> keyed;
+    int n = 0;
+    for (size_t j = 0; j < repeat_planes.size(); j += n)
+    {
+      n = std::count(repeat_planes.begin(), repeat_planes.end(), repeat_planes[j]);
+      for (int k = 0; k < n; k++)
+        keyed.push_back({((2 * k + 1) << 16) / (2 * n), repeat_planes[j]});
+    }
+
+    std::stable_sort(keyed.begin(), keyed.end(), [](const std::pair<uint32_t, uint8_t> &a, const std::pair<uint32_t, uint8_t> &b) { return a.first < b.first; });
+
+    for (size_t j = 0; j < keyed.size(); j++)
+      repeat_planes[j] = keyed[j].second;
+  }
+  else if (m_cfg.row_scan_order == HUB75_I2S_CFG::SCAN_SCRAMBLED)
+  {
+    ESP_LOGW("I2S-DMA", "Bitplane repeats don't have equal OE windows with lsbMsbTransitionBit %d, only scrambling the row order.", lsbMsbTransitionBit);
+  }
+
   //fbs_required = 1; // (m_cfg.double_buff) ? 2 : 1;
   for (int fb = 0; fb < (fbs_required); fb++)
   {  
 	
 	int _dmadescriptor_count = 0; // for tracking
 	
-    for (int row = 0; row < ROWS_PER_FRAME; row++)
+    for (int slot = 0; slot < ROWS_PER_FRAME; slot++)
     {
+	  int row = scanRow(slot);
 	  //ESP_LOGV("I2S-DMA", ">>> Linking DMA descriptors for output row %d", row);    	
 		
 	  // Link and send all colour data, all passes of everything in one hit. 1 bit colour at least...
@@ -264,14 +387,8 @@ bool MatrixPanel_I2S_DMA::setupDMA(const HUB75_I2S_CFG &_cfg)
 	  }
 	
       // Step 2: Handle additional descriptors for bits beyond the lsbMsbTransitionBit 
-      for (int i = lsbMsbTransitionBit + 1; i < m_cfg.getPixelColorDepthBits(); i++) 
+	  for (uint8_t i : repeat_planes)
 	  {
-		  // binary time division setup: we need 2 of bit (LSBMSB_TRANSITION_BIT + 1) four of (LSBMSB_TRANSITION_BIT + 2), etc
-		  // because we sweep through to MSB each time, it divides the number of times we have to sweep in half (saving linked list RAM)
-		  // we need 2^(i - LSBMSB_TRANSITION_BIT - 1) == 1 << (i - LSBMSB_TRANSITION_BIT - 1) passes from i to MSB
-
-		  for (int k = 0; k < (1 << (i - lsbMsbTransitionBit - 1)); k++)
-		  {		  
 			  // Link and send all colour data, all passes of everything in one hit.
 			  for (int dma_desc_1cdepth = 0; dma_desc_1cdepth < dma_descs_per_row_1cdepth; dma_desc_1cdepth++) 
 			  {		  
@@ -286,9 +403,8 @@ bool MatrixPanel_I2S_DMA::setupDMA(const HUB75_I2S_CFG &_cfg)
 				// Log the updated descriptor count after each operation.
 			//	ESP_LOGV("I2S-DMA", "Updated _dmadescriptor_count: %d", _dmadescriptor_count);		
 			  }
-		  } // end K
 		
-      } // end all other colour depth bits
+	  } // end all bitplane repeats
 	  
 
     } // end all rows
@@ -330,6 +446,24 @@ bool MatrixPanel_I2S_DMA::setupDMA(const HUB75_I2S_CFG &_cfg)
    */  
 
   fb = &frame_buffer[0];
+
+#if defined(TEMPORAL_DITHER)
+  if (m_cfg.getPixelColorDepthBits() > 10)
+  {
+    ESP_LOGE("I2S-DMA", "TEMPORAL_DITHER needs a colour depth of 10 bits or less.");
+    return false;
+  }
+
+  if (temporalDither())
+  {
+    ESP_LOGI("I2S-DMA", "Temporal dithering: %d bit output, %d Hz dither period.", m_cfg.getPixelColorDepthBits() + 2, calculated_refresh_rate / 2);
+    dma_bus.alternate_dma_output_buffers();
+  }
+  else
+  {
+    ESP_LOGW("I2S-DMA", "TEMPORAL_DITHER needs double_buff for the second phase, drawFrameRGB565() will only dither spatially.");
+  }
+#endif
   
 
   //
@@ -368,6 +502,51 @@ bool MatrixPanel_I2S_DMA::setupDMA(const HUB75_I2S_CFG &_cfg)
 
 } // end setupDMA
 
+/**
+ * @brief - work out which row the DMA engine outputs in each scan slot
+ * Camera friendly order is bit reversed (0, 16, 8, 24, 4...) so consecutive slots are as far apart on the
+ * panel as possible and any band of rows is lit several times per refresh rather than once.
+ */
+void MatrixPanel_I2S_DMA::setupScanOrder()
+{
+  scan_rows.clear();
+  scan_rows.reserve(ROWS_PER_FRAME);
+
+  bool scrambled = (m_cfg.row_scan_order == HUB75_I2S_CFG::SCAN_SCRAMBLED);
+
+  // Shift register row decoders can only step to the next row
+  if (scrambled && (m_cfg.line_decoder == HUB75_I2S_CFG::SM5266P || m_cfg.line_decoder == HUB75_I2S_CFG::SM5368))
+  {
+    ESP_LOGW("I2S-DMA", "Scrambled scan order isn't possible with a shift register row decoder, using sequential.");
+    scrambled = false;
+  }
+
+  if (!scrambled)
+  {
+    for (int row = 0; row < ROWS_PER_FRAME; row++)
+      scan_rows.push_back(row);
+
+    return;
+  }
+
+  int bits = 0;
+  while ((1 << bits) < ROWS_PER_FRAME)
+    bits++;
+
+  // Bit reverse every index up to the next power of two, skipping the ones past the last row
+  for (int idx = 0; idx < (1 << bits); idx++)
+  {
+    int row = 0;
+    for (int b = 0; b < bits; b++)
+      row |= ((idx >> b) & 1) << (bits - 1 - b);
+
+    if (row < ROWS_PER_FRAME)
+      scan_rows.push_back(row);
+  }
+
+  ESP_LOGI("I2S-DMA", "Scrambled scan order, rows %d, %d, %d, %d...", scan_rows[0], scan_rows[1 % ROWS_PER_FRAME], scan_rows[2 % ROWS_PER_FRAME], scan_rows[3 % ROWS_PER_FRAME]);
+}
+
 /* There are 'bits' set in the frameStruct that we simply don't need to set every single time we change a pixel / DMA buffer co-ordinate.
  *  For example, the bits that determine the address lines, we don't need to set these every time. Once they're in place, and assuming we
  *  don't accidentally clear them, then we don't need to set them again.
@@ -400,6 +579,16 @@ void IRAM_ATTR MatrixPanel_I2S_DMA::updateMatrixDMABuffer(uint16_t x_coord, uint
     return;
   }
 
+#if defined(TEMPORAL_DITHER)
+  // Both buffers are on screen with temporal dithering, so plain drawing has to go to both
+  if (temporalDither() && fb == &frame_buffer[0])
+  {
+    fb = &frame_buffer[1];
+    updateMatrixDMABuffer(x_coord, y_coord, red, green, blue);
+    fb = &frame_buffer[0];
+  }
+#endif
+
   /* LED Brightness Compensation. Because if we do a basic "red & mask" for example,
    * we'll NEVER send the dimmest possible colour, due to binary skew.
    * i.e. It's almost impossible for colour_depth_idx of 0 to be sent out to the MATRIX unless the 'value' of a colour is exactly '1'
@@ -470,6 +659,16 @@ void MatrixPanel_I2S_DMA::updateMatrixDMABuffer(uint8_t red, uint8_t green, uint
   if (!initialized)
     return;
 
+#if defined(TEMPORAL_DITHER)
+  // Both buffers are on screen with temporal dithering, so plain drawing has to go to both
+  if (temporalDither() && fb == &frame_buffer[0])
+  {
+    fb = &frame_buffer[1];
+    updateMatrixDMABuffer(red, green, blue);
+    fb = &frame_buffer[0];
+  }
+#endif
+
   /* https://ledshield.wordpress.com/2012/11/13/led-brightness-to-your-eye-gamma-correction-no/ */
   DO_BRIGHTNESS_COMPENSATION()  
 
@@ -521,6 +720,155 @@ void MatrixPanel_I2S_DMA::updateMatrixDMABuffer(uint8_t red, uint8_t green, uint
   }                                      // colour depth loop (8)
 } // updateMatrixDMABuffer (full frame paint)
 
+/* Update both rows of a scan slot from a full RGB565 frame - used by drawFrameRGB565 */
+void IRAM_ATTR MatrixPanel_I2S_DMA::updateMatrixDMARowPair(uint16_t row_idx, const uint16_t *frame, uint8_t phase)
+{
+  const uint16_t *top_row = frame + row_idx * PIXELS_PER_ROW;
+  const uint16_t *bottom_row = frame + (row_idx + ROWS_PER_FRAME) * PIXELS_PER_ROW;
+  const uint8_t colour_depth = m_cfg.getPixelColorDepthBits();
+#if !defined(TEMPORAL_DITHER)
+  const bool rgb565_source = (m_cfg.source == HUB75_I2S_CFG::SOURCE_RGB565);
+#endif
+
+  for (uint16_t x = 0; x < PIXELS_PER_ROW; x++)
+  {
+    uint16_t top_r, top_g, top_b, bottom_r, bottom_g, bottom_b;
+    uint8_t red, green, blue;
+
+#if !defined(TEMPORAL_DITHER)
+    if (rgb565_source)
+    {
+      // straight from the 5/6-bit channels, no expanding to RGB888 first
+      top_r = source_lut.red(top_row[x]);
+      top_g = source_lut.green(top_row[x]);
+      top_b = source_lut.blue(top_row[x]);
+      bottom_r = source_lut.red(bottom_row[x]);
+      bottom_g = source_lut.green(bottom_row[x]);
+      bottom_b = source_lut.blue(bottom_row[x]);
+    }
+    else
+#endif
+    {
+      {
+        color565to888(top_row[x], red, green, blue);
+#if defined(TEMPORAL_DITHER)
+        DO_DITHERED_COMPENSATION(dither_threshold[phase][row_idx & 1][x & 1])
+#else
+        DO_BRIGHTNESS_COMPENSATION()
+#endif
+        top_r = red_val;
+        top_g = green_val;
+        top_b = blue_val;
+      }
+
+      {
+        color565to888(bottom_row[x], red, green, blue);
+#if defined(TEMPORAL_DITHER)
+        DO_DITHERED_COMPENSATION(dither_threshold[phase][(row_idx + ROWS_PER_FRAME) & 1][x & 1])
+#else
+        DO_BRIGHTNESS_COMPENSATION()
+#endif
+        bottom_r = red_val;
+        bottom_g = green_val;
+        bottom_b = blue_val;
+      }
+    }
+
+    uint16_t x_coord = ESP32_TX_FIFO_POSITION_ADJUST(x);
+
+    for (uint8_t colour_depth_idx = 0; colour_depth_idx < colour_depth; colour_depth_idx++)
+    {
+      uint16_t mask = (1 << colour_depth_idx);
+
+      /* Per the .h file, the order of the output RGB bits is:
+       * BIT_B2, BIT_G2, BIT_R2,    BIT_B1, BIT_G1, BIT_R1     */
+      uint16_t RGB_output_bits = ((bool)(bottom_b & mask) << 5) | ((bool)(bottom_g & mask) << 4) | ((bool)(bottom_r & mask) << 3) |
+                                 ((bool)(top_b & mask) << 2)    | ((bool)(top_g & mask) << 1)    | (bool)(top_r & mask);
+
+      ESP32_I2S_DMA_STORAGE_TYPE *p = getRowDataPtr(row_idx, colour_depth_idx);
+      p[x_coord] = (p[x_coord] & BITMASK_RGB12_CLEAR) | RGB_output_bits;
+    }
+  }
+
+#if defined(SPIRAM_DMA_BUFFER)
+  Cache_WriteBack_Addr((uint32_t)fb->rowBits[row_idx]->getDataPtr(0), fb->rowBits[row_idx]->getColorDepthSize(false));
+#endif
+} // updateMatrixDMARowPair
+
+/**
+ * @brief - encode a complete RGB565 frame into the DMA buffer
+ * Without double buffering the row pairs are written just ahead of the DMA scan, starting from the top of the
+ * next refresh, so no refresh shows half of each frame. Refer to ESP32-HUB75-MatrixPanel-BeamRace.hpp
+ * Blocks for up to one refresh period waiting for the scanner to get to the end of the current refresh.
+ */
+void MatrixPanel_I2S_DMA::drawFrameRGB565(const uint16_t *frame, bool beam_race)
+{
+  if (!initialized || frame == nullptr)
+    return;
+
+  // A back buffer already hides the redraw, and without a scan position there is nothing to race.
+  // Temporal dithering uses both buffers as the two phases of the frame on screen, so that is raced like a single buffer.
+  beam_race = beam_race && (!m_cfg.double_buff || temporalDither()) && dma_bus.row_eof_enabled();
+
+  // Don't wait forever if the scan position stops moving (i.e. stopDMAoutput()), two refreshes is plenty.
+  const uint32_t max_wait_us = (calculated_refresh_rate > 0) ? (2000000UL / calculated_refresh_rate) : 50000;
+
+  BeamRaceScheduler scheduler(ROWS_PER_FRAME);
+  scheduler.begin(dma_bus.get_rows_scanned());
+
+  // Sleep (rather than spin) until the scanner is about to finish the current refresh
+  if (beam_race)
+  {
+    int64_t sleep_start = esp_timer_get_time();
+    bool reached = dma_bus.wait_rows_scanned(scheduler.startAt(), max_wait_us / 1000 + 1);
+    beam_race_sleep_us += esp_timer_get_time() - sleep_start;
+
+    if (!reached)
+    {
+      ESP_LOGW("I2S-DMA", "drawFrameRGB565: scan position isn't moving, writing without beam racing.");
+      beam_race = false;
+    }
+  }
+
+  while (!scheduler.done())
+  {
+    bool late = false;
+
+    if (beam_race)
+    {
+      BeamRaceScheduler::action_t action;
+      uint32_t waited_us = 0;
+
+      while ((action = scheduler.poll(dma_bus.get_rows_scanned())) == BeamRaceScheduler::ROW_WAIT && waited_us < max_wait_us)
+      {
+        esp_rom_delay_us(1);
+        waited_us++;
+      }
+
+      late = (action != BeamRaceScheduler::ROW_WRITE);
+    }
+
+    uint16_t row = scanRow(scheduler.nextRow());
+
+    if (temporalDither())
+    {
+      fb = &frame_buffer[1];
+      updateMatrixDMARowPair(row, frame, 1);
+      fb = &frame_buffer[0];
+    }
+
+    updateMatrixDMARowPair(row, frame, 0);
+    scheduler.rowWritten(late);
+  }
+
+  if (scheduler.lateRows())
+  {
+    beam_race_late_rows += scheduler.lateRows();
+    ESP_LOGV("I2S-DMA", "drawFrameRGB565: %d rows written behind the scanner.", scheduler.lateRows());
+  }
+
+} // drawFrameRGB565
+
 /**
  * @brief - clears and reinitializes colour/control data in DMA buffs
  * When allocated, DMA buffs might be dirty, so we need to blank it and initialize ABCDE,LAT,OE control bits.
@@ -571,11 +919,8 @@ void MatrixPanel_I2S_DMA::clearFrameBuffer(bool _buff_id)
 
 	// The colour_index[0] (LSB) x_pixels must be "marked" with a previous's row address, because it is used to display
 	// previous row while we pump in MSBs's for the next row.
-	if (row_idx == 0) { 
-		abcde = ROWS_PER_FRAME-1; // wrap around
-	} else {
-		abcde = row_idx-1;	
-	}
+	// (the previous row in scan order, which with SCAN_SCRAMBLED isn't row_idx-1)
+	abcde = scanPrevRow(row_idx);
 
     abcde <<= BITS_ADDR_OFFSET; // shift row y-coord to match ABCDE bits in vector from 8 to 12		
 	do
@@ -692,10 +1037,7 @@ void MatrixPanel_I2S_DMA::setBrightnessOE(uint8_t brt, const int _buff_id)
     {
       --colouridx;
 
-      char bitplane = (2 * _depth - colouridx) % _depth;
-      char bitshift = (_depth - lsbMsbTransitionBit - 1) >> 1;
-
-      char rightshift = std::max(bitplane - bitshift - 2, 0);
+      char rightshift = bcmOeShift(colouridx);
 
       // Calculate the OE disable period by brightness and latch blanking.
       // First, determine the maximum pixels for this specific bitplane (accounting for PWM time weighting).
@@ -836,6 +1178,16 @@ void MatrixPanel_I2S_DMA::hlineDMA(int16_t x_coord, int16_t y_coord, int16_t l,
 
   l = ((x_coord + l) >= PIXELS_PER_ROW) ? (PIXELS_PER_ROW - x_coord) : l;
 
+#if defined(TEMPORAL_DITHER)
+  // Both buffers are on screen with temporal dithering, so plain drawing has to go to both
+  if (temporalDither() && fb == &frame_buffer[0])
+  {
+    fb = &frame_buffer[1];
+    hlineDMA(x_coord, y_coord, l, red, green, blue);
+    fb = &frame_buffer[0];
+  }
+#endif
+
   // if (x_coord+l > PIXELS_PER_ROW)
   //    l = PIXELS_PER_ROW - x_coord + 1;     // reset width to end of row
 
@@ -920,6 +1272,16 @@ void MatrixPanel_I2S_DMA::vlineDMA(int16_t x_coord, int16_t y_coord, int16_t l,
 
   // check for a length that goes beyond the height of the screen! Array out of bounds dma memory changes = screwed output #163
   l = ((y_coord + l) >= m_cfg.mx_height) ? (m_cfg.mx_height - y_coord) : l;
+
+#if defined(TEMPORAL_DITHER)
+  // Both buffers are on screen with temporal dithering, so plain drawing has to go to both
+  if (temporalDither() && fb == &frame_buffer[0])
+  {
+    fb = &frame_buffer[1];
+    vlineDMA(x_coord, y_coord, l, red, green, blue);
+    fb = &frame_buffer[0];
+  }
+#endif
   // if (y_coord + l > m_cfg.mx_height)
   ///    l = m_cfg.mx_height - y_coord + 1;     // reset width to end of col
 
@@ -4,6 +4,7 @@
 /* Core ESP32 hardware / idf includes!                                                 */
 #include <vector>
 #include <memory>
+#include <algorithm>
 #include <esp_err.h>
 #include <esp_log.h>
 #include "esp_attr.h"
@@ -220,6 +221,7 @@ struct frameStruct
 //
 // Contains native bit-depth LUTs (6, 7, 8, 10, 12-bit) for optimal performance and quality.
 #include "cie_luts.h"
+#include "ESP32-HUB75-MatrixPanel-RGB565.hpp"
 
 /** @brief - configuration values for HUB75_I2S driver
  *  This structure holds configuration vars that are used as
@@ -263,6 +265,45 @@ struct HUB75_I2S_CFG
     HZ_20M = 20000000 // for compatability  
   };
 
+  /**
+   * Binary code modulation scheme for the bitplanes below/above lsbMsbTransitionBit
+   *  BCM_PLANE_REPEAT - planes above the transition bit are weighted by repeating their row payload (original behaviour)
+   *  BCM_OE_WEIGHTED  - planes up to the transition bit are weighted by shortening the OE window inside a single payload,
+   *                     only the planes above it are repeated. Fewer descriptors and payloads per row -> higher refresh.
+   */
+  enum bcm_mode
+  {
+    BCM_PLANE_REPEAT = 0,
+    BCM_OE_WEIGHTED
+  };
+
+  /**
+   * Order in which the DMA engine visits the rows and bitplane repeats
+   *  SCAN_SEQUENTIAL - rows top to bottom, each row's bitplane repeats in ascending order (original behaviour)
+   *  SCAN_SCRAMBLED  - rows in bit reversed order so neighbouring rows are lit half a refresh apart, and the bitplane
+   *                    repeats within a row spread out instead of sending the MSB in one long block. Breaks up the
+   *                    rolling bands phone cameras pick up, same memory and refresh rate. TYPE138 and TYPE_DIRECT
+   *                    decoders only, the shift register ones (TYPE595 / SM5368, SM5266P) can only step to the next
+   *                    row and stay sequential.
+   */
+  enum scan_order
+  {
+    SCAN_SEQUENTIAL = 0,
+    SCAN_SCRAMBLED
+  };
+
+  /**
+   * What the pixel data comes from
+   *  SOURCE_RGB888 - full 8 bits per channel, the colour depth is used as configured
+   *  SOURCE_RGB565 - a 16 bit canvas (drawFrameRGB565). The colour depth is cut to the least that still shows every
+   *                  5/6-bit level (when the brightness tables allow it) and drawFrameRGB565 uses 5/6-bit input tables.
+   */
+  enum colour_source
+  {
+    SOURCE_RGB888 = 0,
+    SOURCE_RGB565
+  };
+
   //
   // Members must be in order of declaration or it breaks Arduino compiling due to strict checking.
   //
@@ -315,6 +356,15 @@ struct HUB75_I2S_CFG
   // Set this to '1' to get all colour depths displayed with correct BCM time weighting.
   uint8_t min_refresh_rate;
 
+  // How the bitplanes are time weighted, see bcm_mode
+  bcm_mode modulation;
+
+  // Row / bitplane scan order, see scan_order
+  scan_order row_scan_order;
+
+  // Pixel data precision, see colour_source
+  colour_source source;
+
   // struct constructor
   HUB75_I2S_CFG(
       uint16_t _w = MATRIX_WIDTH,
@@ -331,8 +381,11 @@ struct HUB75_I2S_CFG
       uint8_t _latblk = DEFAULT_LAT_BLANKING, // Anything > 1 seems to cause artefacts on ICS panels
       bool _clockphase = true, 
       uint16_t _min_refresh_rate = 60, 
-      uint8_t _pixel_color_depth_bits = PIXEL_COLOR_DEPTH_BITS_DEFAULT) 
-      : mx_width(_w), mx_height(_h), chain_length(_chain), gpio(_pinmap), driver(_drv), double_buff(_dbuff), i2sspeed(_i2sspeed), latch_blanking(_latblk), clkphase(_clockphase), min_refresh_rate(_min_refresh_rate)
+      uint8_t _pixel_color_depth_bits = PIXEL_COLOR_DEPTH_BITS_DEFAULT,
+      bcm_mode _modulation = BCM_PLANE_REPEAT,
+      scan_order _row_scan_order = SCAN_SEQUENTIAL,
+      colour_source _source = SOURCE_RGB888) 
+      : mx_width(_w), mx_height(_h), chain_length(_chain), gpio(_pinmap), driver(_drv), line_decoder(_line_drv), double_buff(_dbuff), i2sspeed(_i2sspeed), latch_blanking(_latblk), clkphase(_clockphase), min_refresh_rate(_min_refresh_rate), modulation(_modulation), row_scan_order(_row_scan_order), source(_source)
   {
     setPixelColorDepthBits(_pixel_color_depth_bits);
   }
@@ -605,6 +658,40 @@ public:
 
   void drawIcon(int *ico, int16_t x, int16_t y, int16_t cols, int16_t rows);
 
+  /**
+   * @brief - encode a complete RGB565 frame straight into the DMA buffer, a row pair at a time
+   * Much quicker than a drawPixel() per pixel, and without double buffering the rows are written
+   * racing the DMA scan (see ESP32-HUB75-MatrixPanel-BeamRace.hpp) so the update doesn't tear.
+   * This blocks the calling task for up to one refresh period while it waits for the scanner.
+   * Note: no rotation is applied, the frame is in native panel chain co-ordinates.
+   * @param frame - PIXELS_PER_ROW x mx_height pixels, row major (i.e. a GFXcanvas16 buffer)
+   * @param beam_race - sync the row writes to the scan position, when the platform can report it
+   */
+  void drawFrameRGB565(const uint16_t *frame, bool beam_race = true);
+
+  /**
+   * @brief - row pair the DMA engine is currently shifting out
+   * @returns - 0 to (mx_height/2)-1, or -1 if the platform can't report the scan position
+   */
+  int getScanRow() const
+  {
+    if (!initialized || !dma_bus.row_eof_enabled())
+      return -1;
+
+    return scanRow(dma_bus.get_rows_scanned() % ROWS_PER_FRAME);
+  }
+
+  /**
+   * @brief - total rows drawFrameRGB565() had to write after the scanner had already passed them (i.e. torn refreshes)
+   */
+  uint32_t getBeamRaceLateRows() const { return beam_race_late_rows; }
+
+  /**
+   * @brief - total time drawFrameRGB565() has spent asleep waiting for the scanner to reach the end of a refresh,
+   * for taking out of the caller's CPU time. The spin just ahead of the scanner isn't included, that's still the CPU's.
+   */
+  uint64_t getBeamRaceSleepUs() const { return beam_race_sleep_us; }
+
   // Colour 444 is a 4 bit scale, so 0 to 15, colour 565 takes a 0-255 bit value, so scale up by 255/15 (i.e. 17)!
   static uint16_t color444(uint8_t r, uint8_t g, uint8_t b) { return color565(r * 17, g * 17, b * 17); }
   static uint16_t color565(uint8_t r, uint8_t g, uint8_t b); // This is what is used by Adafruit GFX!
@@ -618,7 +705,8 @@ public:
 
   inline void flipDMABuffer()
   {
-    if (!m_cfg.double_buff)
+    // With temporal dithering the DMA engine alternates between the two buffers by itself
+    if (!m_cfg.double_buff || temporalDither())
     {
       return;
     }
@@ -730,6 +818,9 @@ protected:
   /* Update the entire DMA buffer (aka. The RGB Panel) a certain colour (wipe the screen basically) */
   void updateMatrixDMABuffer(uint8_t red, uint8_t green, uint8_t blue);
 
+  /* Update all the colour bits of one row pair (scan slot) from a full RGB565 frame, phase picks the TEMPORAL_DITHER pattern */
+  void updateMatrixDMARowPair(uint16_t row_idx, const uint16_t *frame, uint8_t phase = 0);
+
   /**
    * wipes DMA buffer(s) and reset all colour/service bits
    */
@@ -783,6 +874,72 @@ private:
   /* Setup the DMA Link List chain and configure the ESP32 DMA + I2S or LCD peripheral */
   bool setupDMA(const HUB75_I2S_CFG &opts);
 
+  /**
+   * @brief - number of extra row payloads (on top of the one every plane gets) used to time weight a bitplane
+   * @param plane - colour depth bit index, only planes above lsbMsbTransitionBit are ever repeated
+   */
+  int bcmExtraPasses(int plane) const
+  {
+    if (plane <= lsbMsbTransitionBit)
+      return 0;
+
+    int passes = 1 << (plane - lsbMsbTransitionBit - 1);
+
+    // With OE weighting the planes up to the transition bit take the fractions, so the first plane after it is worth exactly one payload
+    return (m_cfg.modulation == HUB75_I2S_CFG::BCM_OE_WEIGHTED) ? passes - 1 : passes;
+  }
+
+  /**
+   * @brief - how far the OE window of a colour index subrow is shortened (right shift of the full window)
+   * @param colouridx - colour depth bit index of the row payload
+   */
+  int bcmOeShift(uint8_t colouridx) const
+  {
+    const int _depth = m_cfg.getPixelColorDepthBits();
+
+    if (m_cfg.modulation == HUB75_I2S_CFG::BCM_OE_WEIGHTED)
+    {
+      // A payload's OE window lights what was latched at the end of the previous payload, i.e. the previous
+      // bitplane (plane 0's payload shows the last, MSB, payload of the previous row). Planes above the
+      // transition bit get the full window, those at or below it get 1/2, 1/4 ... of it.
+      int shown_plane = (colouridx + _depth - 1) % _depth;
+      return std::max(lsbMsbTransitionBit + 1 - shown_plane, 0);
+    }
+
+    int bitplane = (2 * _depth - colouridx) % _depth;
+    int bitshift = (_depth - lsbMsbTransitionBit - 1) >> 1;
+
+    return std::max(bitplane - bitshift - 2, 0);
+  }
+
+  /* Both buffers are output in turn as the two phases of a temporally dithered frame, see TEMPORAL_DITHER */
+  bool temporalDither() const
+  {
+#if defined(TEMPORAL_DITHER)
+    return m_cfg.double_buff;
+#else
+    return false;
+#endif
+  }
+
+  /* Build the scan slot -> row table (scan_rows) for m_cfg.row_scan_order */
+  void setupScanOrder();
+
+  /* Row output just before row_idx, whose address row_idx's LSB payload has to carry */
+  uint8_t scanPrevRow(uint8_t row_idx) const
+  {
+    for (uint8_t slot = 0; slot < scan_rows.size(); slot++)
+    {
+      if (scan_rows[slot] == row_idx)
+        return scan_rows[(slot + ROWS_PER_FRAME - 1) % ROWS_PER_FRAME];
+    }
+
+    return (row_idx == 0) ? ROWS_PER_FRAME - 1 : row_idx - 1;
+  }
+
+  /* Row output in a scan slot */
+  uint8_t scanRow(uint16_t slot) const { return scan_rows.empty() ? slot : scan_rows[slot]; }
+
   /**
    * pre-init procedures for specific drivers
    *
@@ -878,6 +1035,10 @@ private:
   volatile int back_buffer_id = 0;      // If using double buffer, which one is NOT active (ie. being displayed) to write too?
   int brightness = 128;        // If you get ghosting... reduce brightness level. ((60/64)*255) seems to be the limit before ghosting on a 64 pixel wide physical panel for some panels.
   int lsbMsbTransitionBit = 0; // For colour depth calculations
+  uint32_t beam_race_late_rows = 0; // drawFrameRGB565() rows that lost the race with the scanner
+  uint64_t beam_race_sleep_us = 0;  // drawFrameRGB565() time asleep waiting for the scanner
+  std::vector<uint8_t> scan_rows;   // row output in each scan slot, see HUB75_I2S_CFG::scan_order
+  RGB565SourceLUT source_lut;       // drawFrameRGB565() brightness tables for HUB75_I2S_CFG::SOURCE_RGB565
 
   /* ESP32-HUB75-MatrixPanel-I2S-DMA functioning constants
    * we should not those once object instance initialized it's DMA structs
@@ -0,0 +1,85 @@
+#pragma once
+
+#include <stdint.h>
+#include <math.h>
+
+/***************************************************************************************/
+/* Brightness tables for RGB565 source content.
+ *
+ * A GFXcanvas16 only holds 5 bits of red and blue and 6 bits of green, yet the normal path expands every
+ * pixel to RGB888 and looks it up in a 256 entry table. These tables go straight from the 5/6-bit channel
+ * value to the output level at the panel's colour depth, with the same CIE 1931 curve as cie_luts.h.
+ *
+ * All three channels share the same bitplanes, so the colour depth can only be cut as far as the most demanding
+ * channel allows. sourceDepthBits() works out how far that is - the lowest depth that still shows every level the
+ * configured depth would. Dark levels are what need the bits: after CIE correction the first step of a 5-bit
+ * channel is under 1/255 of full scale, so that's 8 bits, whereas linear output gets away with 6.
+ *
+ * No ESP-IDF dependencies so the same code is used by the host tool under /testing.
+ */
+
+class RGB565SourceLUT
+{
+public:
+  /**
+   * @brief - fill the tables for an output colour depth
+   * @param depth - bitplanes per colour
+   * @param cie - CIE 1931 correction (false for NO_CIE1931 builds)
+   */
+  void build(uint8_t depth, bool cie)
+  {
+    for (uint8_t i = 0; i < 32; i++)
+      rb[i] = level(i, 5, depth, cie);
+
+    for (uint8_t i = 0; i < 64; i++)
+      g[i] = level(i, 6, depth, cie);
+  }
+
+  uint16_t red(uint16_t colour) const { return rb[colour >> 11]; }
+  uint16_t green(uint16_t colour) const { return g[(colour >> 5) & 0x3F]; }
+  uint16_t blue(uint16_t colour) const { return rb[colour & 0x1F]; }
+
+  /** @brief - output level of source value 'v' of a 'source_bits' wide channel */
+  static uint16_t level(uint8_t v, uint8_t source_bits, uint8_t depth, bool cie)
+  {
+    float x = (float)v / ((1 << source_bits) - 1);
+
+    if (cie)
+    {
+      float L = x * 100.0f;
+      x = (L <= 8.0f) ? (L / 902.3f) : powf((L + 16.0f) / 116.0f, 3.0f);
+    }
+
+    return (uint16_t)lroundf(x * ((1 << depth) - 1));
+  }
+
+  /** @brief - how many of a channel's source levels are still told apart at a colour depth */
+  static uint8_t distinctLevels(uint8_t source_bits, uint8_t depth, bool cie)
+  {
+    uint8_t count = 1;
+
+    for (uint8_t v = 1; v < (1 << source_bits); v++)
+    {
+      if (level(v, source_bits, depth, cie) != level(v - 1, source_bits, depth, cie))
+        count++;
+    }
+
+    return count;
+  }
+
+  /** @brief - lowest colour depth showing as many RGB565 levels as max_depth does */
+  static uint8_t sourceDepthBits(uint8_t max_depth, bool cie)
+  {
+    uint8_t depth = max_depth;
+
+    while (depth > 2 && distinctLevels(5, depth - 1, cie) == distinctLevels(5, max_depth, cie) &&
+           distinctLevels(6, depth - 1, cie) == distinctLevels(6, max_depth, cie))
+      depth--;
+
+    return depth;
+  }
+
+private:
+  uint16_t rb[32] = {};
+  uint16_t g[64] = {};
+};
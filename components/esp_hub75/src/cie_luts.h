@@ -138,7 +138,7 @@ static const uint16_t lumConvTab_10bit[256] = {
 };
 #endif
 
-#if !defined(PIXEL_COLOR_DEPTH_BITS) || PIXEL_COLOR_DEPTH_BITS == 12
+#if !defined(PIXEL_COLOR_DEPTH_BITS) || PIXEL_COLOR_DEPTH_BITS == 12 || defined(TEMPORAL_DITHER)
 // 12-bit CIE 1931 lookup table
 // Maps 8-bit input (0-255) to 12-bit output (0-4095)
 static const uint16_t lumConvTab_12bit[256] = {
@@ -624,6 +624,16 @@ Modified heavily for the ESP32 HUB75 DMA library by:
 
   } // end flip
 
+  void Bus_Parallel16::alternate_dma_output_buffers()
+  {
+    if (!_dmadesc_b)
+      return;
+
+    _dmadesc_a[_dmadesc_last].qe.stqe_next = &_dmadesc_b[0];
+    _dmadesc_b[_dmadesc_last].qe.stqe_next = &_dmadesc_a[0];
+
+  } // end alternate
+
 
 
 #endif
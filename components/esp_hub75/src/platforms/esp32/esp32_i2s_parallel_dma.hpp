@@ -123,6 +123,15 @@ i2s_dev_t* getDev();
     void dma_transfer_stop();
 
     void flip_dma_output_buffer(int buffer_id);
+
+    // Link the two descriptor chains into one loop so buffer a and b are output on alternate refreshes
+    void alternate_dma_output_buffers();
+
+    // Scan position tracking isn't implemented for the I2S peripheral (yet), so beam racing is disabled.
+    void enable_row_eof(uint32_t /*descs_per_row*/) { }
+    bool row_eof_enabled() const { return false; }
+    uint32_t get_rows_scanned() const { return 0; }
+    bool wait_rows_scanned(uint32_t /*count*/, uint32_t /*timeout_ms*/) { return false; }
   
   private:
 
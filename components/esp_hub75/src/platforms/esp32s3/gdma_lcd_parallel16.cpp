@@ -63,6 +63,40 @@
     return &LCD_CAM;
   }
 
+  // Row EOF callback - counts rows scanned out, used for beam racing single buffered updates.
+  IRAM_ATTR bool Bus_Parallel16::on_dma_row_eof(gdma_channel_handle_t dma_chan,
+                                    gdma_event_data_t *event_data, void *user_data) {
+
+    Bus_Parallel16 *bus = (Bus_Parallel16 *)user_data;
+    uint32_t rows = bus->_dmadesc_count / bus->_descs_per_row;
+
+#if ESP_IDF_VERSION >= ESP_IDF_VERSION_VAL(5, 0, 0)
+    // Re-sync from the descriptor that raised the EOF, so a late or coalesced interrupt can't leave the count a row out.
+    HUB75_DMA_DESCRIPTOR_T *desc = (HUB75_DMA_DESCRIPTOR_T *)event_data->tx_eof_desc_addr;
+    HUB75_DMA_DESCRIPTOR_T *base = bus->_dmadesc_a;
+
+    if (bus->_dmadesc_b && desc >= bus->_dmadesc_b && desc < (bus->_dmadesc_b + bus->_dmadesc_count)) {
+      base = bus->_dmadesc_b;
+    }
+
+    uint32_t next_row = ((uint32_t)(desc - base) / bus->_descs_per_row + 1) % rows;
+    uint32_t count    = bus->_rows_scanned;
+    bus->_rows_scanned = count + (next_row + rows - (count % rows)) % rows;
+#else
+    bus->_rows_scanned = bus->_rows_scanned + 1;
+#endif
+
+    BaseType_t task_woken = pdFALSE;
+
+    if (bus->_rows_waiting && (int32_t)(bus->_rows_scanned - bus->_rows_wait_for) >= 0)
+    {
+      bus->_rows_waiting = false;
+      xSemaphoreGiveFromISR(bus->_rows_sem, &task_woken);
+    }
+
+    return (task_woken == pdTRUE);
+  }
+
   // ------------------------------------------------------------------------------
 
   void Bus_Parallel16::config(const config_t& cfg)
@@ -268,6 +302,19 @@
     gdma_register_tx_event_callbacks(dma_chan, &tx_cbs, NULL);
 */
 
+    // Per-row EOF callback to track the scan position
+    if (_descs_per_row)
+    {
+      if (_rows_sem == nullptr) {
+        _rows_sem = xSemaphoreCreateBinary();
+      }
+
+      static gdma_tx_event_callbacks_t row_eof_cbs = {
+        .on_trans_eof = on_dma_row_eof
+      };
+      gdma_register_tx_event_callbacks(dma_chan, &row_eof_cbs, this);
+    }
+
     // This uses a busy loop to wait for each DMA transfer to complete...
     // but the whole point of DMA is that one's code can do other work in
     // the interim. The CPU is totally free while the transfer runs!
@@ -287,6 +334,29 @@
  }
 
 
+  bool Bus_Parallel16::wait_rows_scanned(uint32_t count, uint32_t timeout_ms)
+  {
+    if (_rows_sem == nullptr)
+      return false;
+
+    xSemaphoreTake(_rows_sem, 0); // clear a give left over from a previous wait that timed out
+
+    _rows_wait_for = count;
+    _rows_waiting  = true;
+
+    // Might already be there (or got there before the ISR could see _rows_waiting)
+    if ((int32_t)(_rows_scanned - count) >= 0)
+    {
+      _rows_waiting = false;
+      return true;
+    }
+
+    bool reached = (xSemaphoreTake(_rows_sem, pdMS_TO_TICKS(timeout_ms)) == pdTRUE);
+    _rows_waiting = false;
+
+    return reached;
+  }
+
   void Bus_Parallel16::release(void)
   {
     if (_i80_bus)
@@ -300,6 +370,11 @@
       _dmadesc_a = nullptr;
       _dmadesc_count = 0;
     }
+    if (_rows_sem)
+    {
+      vSemaphoreDelete(_rows_sem);
+      _rows_sem = nullptr;
+    }
 
   }
 
@@ -358,7 +433,7 @@
 
       _dmadesc_b[_dmadesc_b_idx].dw0.owner = DMA_DESCRIPTOR_BUFFER_OWNER_DMA;
       //_dmadesc_b[_dmadesc_b_idx].dw0.suc_eof = 0;   
-      _dmadesc_b[_dmadesc_b_idx].dw0.suc_eof = (_dmadesc_b_idx == (_dmadesc_count-1));
+      _dmadesc_b[_dmadesc_b_idx].dw0.suc_eof = (_dmadesc_b_idx == (_dmadesc_count-1)) || (_descs_per_row && ((_dmadesc_b_idx+1) % _descs_per_row) == 0);
       _dmadesc_b[_dmadesc_b_idx].dw0.size = _dmadesc_b[_dmadesc_b_idx].dw0.length = size; //sizeof(data);
       _dmadesc_b[_dmadesc_b_idx].buffer = data; //data;
 
@@ -384,7 +459,7 @@
 
       _dmadesc_a[_dmadesc_a_idx].dw0.owner = DMA_DESCRIPTOR_BUFFER_OWNER_DMA;
       //_dmadesc_a[_dmadesc_a_idx].dw0.suc_eof = 0;
-      _dmadesc_a[_dmadesc_a_idx].dw0.suc_eof = (_dmadesc_a_idx == (_dmadesc_count-1));    
+      _dmadesc_a[_dmadesc_a_idx].dw0.suc_eof = (_dmadesc_a_idx == (_dmadesc_count-1)) || (_descs_per_row && ((_dmadesc_a_idx+1) % _descs_per_row) == 0);
       _dmadesc_a[_dmadesc_a_idx].dw0.size = _dmadesc_a[_dmadesc_a_idx].dw0.length = size; //sizeof(data);
       _dmadesc_a[_dmadesc_a_idx].buffer = data; //data;
 
@@ -405,6 +480,7 @@
 
   void Bus_Parallel16::dma_transfer_start()
   {
+    _rows_scanned = 0;                  // chain always starts at row 0
     gdma_start(dma_chan, (intptr_t)&_dmadesc_a[0]); // Start DMA w/updated descriptor(s)
     esp_rom_delay_us(100);              // Must 'bake' a moment before...
     LCD_CAM.lcd_user.lcd_start = 1;        // Trigger LCD DMA transfer
@@ -442,5 +518,15 @@
     
   } // end flip
 
+  void Bus_Parallel16::alternate_dma_output_buffers()
+  {
+    if (!_dmadesc_b)
+      return;
+
+    _dmadesc_a[_dmadesc_count-1].next = (dma_descriptor_t *) &_dmadesc_b[0];
+    _dmadesc_b[_dmadesc_count-1].next = (dma_descriptor_t *) &_dmadesc_a[0];
+
+  } // end alternate
+
 
 #endif
@@ -70,6 +70,9 @@
 #include <esp_heap_caps.h>
 #include <esp_heap_caps_init.h>
 
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+
 
 #if __has_include (<esp_private/periph_ctrl.h>)
  #include <esp_private/periph_ctrl.h>
@@ -150,14 +153,36 @@
 
      void flip_dma_output_buffer(int back_buffer_id);
 
+    // Link the two descriptor chains into one loop so buffer a and b are output on alternate refreshes
+    void alternate_dma_output_buffers();
+
+    // Flag an EOF on the last descriptor of every row so the scan position can be tracked.
+    // Must be called before the descriptors are linked.
+    void enable_row_eof(uint32_t descs_per_row) { _descs_per_row = descs_per_row; }
+    bool row_eof_enabled() const { return _descs_per_row != 0; }
+
+    // Rows completed by the DMA engine since dma_transfer_start(), i.e. the row being output is (count % rows)
+    uint32_t get_rows_scanned() const { return _rows_scanned; }
+
+    // Block the calling task until get_rows_scanned() reaches 'count'. Returns false on timeout.
+    bool wait_rows_scanned(uint32_t count, uint32_t timeout_ms);
+
   private:
 
+    static bool on_dma_row_eof(gdma_channel_handle_t dma_chan, gdma_event_data_t *event_data, void *user_data);
+
     config_t _cfg;
 
     volatile lcd_cam_dev_t* _dev;   
     gdma_channel_handle_t dma_chan; 
 
     uint32_t _dmadesc_count  = 0;   // number of dma decriptors
+    uint32_t _descs_per_row  = 0;   // 0 = no per-row EOF
+
+    volatile uint32_t _rows_scanned = 0;
+    volatile uint32_t _rows_wait_for = 0;
+    volatile bool     _rows_waiting  = false;
+    SemaphoreHandle_t _rows_sem      = nullptr;
 	
     uint32_t _dmadesc_a_idx  = 0;
     uint32_t _dmadesc_b_idx  = 0;
@@ -0,0 +1,90 @@
+#include <iostream>
+#include <iomanip>
+#include <algorithm>
+
+// Refresh rate / DMA descriptor planner for both BCM modes (HUB75_I2S_CFG::modulation), using the same
+// sums as MatrixPanel_I2S_DMA::setupDMA() so the numbers can be checked without flashing anything.
+//
+// g++ -o bcm_plan.exe bcm_plan.cpp
+
+static const int DMA_MAX = 4096 - 4;  // see gdma_lcd_parallel16.hpp
+static const int DESC_BYTES = 12;     // lldesc_t / dma_descriptor_t
+static const int CLKS_DURING_LATCH = 0; // see ESP32-HUB75-MatrixPanel-I2S-DMA.h
+
+struct Plan {
+    int transition;
+    int payloads;   // row payloads sent per row pair
+    int descs;      // DMA descriptors per buffer
+    int refresh_hz;
+    int lsb_pixels; // OE window of bitplane 0 at full brightness
+};
+
+static int extra_passes(int plane, int t, bool oe_weighted)
+{
+    if (plane <= t)
+        return 0;
+    int passes = 1 << (plane - t - 1);
+    return oe_weighted ? passes - 1 : passes;
+}
+
+static Plan plan(int width, int rows, int depth, int clock_hz, int latch_blanking, int min_refresh, bool oe_weighted)
+{
+    Plan p = {};
+    int row_bytes = width * 2;
+    int descs_1cdepth = (row_bytes + DMA_MAX - 1) / DMA_MAX;
+    int descs_all = (row_bytes * depth + DMA_MAX - 1) / DMA_MAX;
+
+    for (int t = 0;; t++)
+    {
+        p.transition = t;
+        p.payloads = depth;
+        for (int i = t + 1; i < depth; i++)
+            p.payloads += extra_passes(i, t, oe_weighted);
+
+        long long ps_per_clock = 1000000000000LL / clock_hz;
+        long long ns_per_latch = (width + CLKS_DURING_LATCH) * ps_per_clock / 1000;
+        p.refresh_hz = (int)(1000000000LL / (ns_per_latch * p.payloads * rows));
+
+        if (p.refresh_hz >= min_refresh)
+            break;
+        if (oe_weighted && ((width - latch_blanking) >> (t + 2)) < 1)
+            break;
+        if (t >= depth - 1)
+            break;
+    }
+
+    int descs_per_row = descs_all;
+    for (int i = p.transition + 1; i < depth; i++)
+        descs_per_row += extra_passes(i, p.transition, oe_weighted) * descs_1cdepth;
+
+    p.descs = descs_per_row * rows;
+    p.lsb_pixels = oe_weighted ? (width - latch_blanking) >> (p.transition + 1) : width - latch_blanking;
+    return p;
+}
+
+int main()
+{
+    const int width = 256, rows = 32, clock = 8000000, blanking = 4;
+
+    for (int depth : {8, 6})
+    {
+    std::cout << "256x64 chain, " << depth << " bits, 8MHz, framebuffer " << width * rows * depth * 2 << " bytes" << std::endl;
+
+    for (int min_refresh : {60, 80, 100, 120})
+    {
+        for (bool oe : {false, true})
+        {
+            Plan p = plan(width, rows, depth, clock, blanking, min_refresh, oe);
+            std::cout << std::left << std::setw(14) << (oe ? "OE weighted" : "plane repeat")
+                      << "min " << std::setw(5) << min_refresh
+                      << "transition bit: " << std::setw(3) << p.transition
+                      << "payloads/row: " << std::setw(4) << p.payloads
+                      << "refresh: " << std::setw(5) << p.refresh_hz
+                      << "descriptors: " << std::setw(5) << p.descs << "(" << p.descs * DESC_BYTES << " bytes)  "
+                      << "LSB OE window: " << p.lsb_pixels << "px" << std::endl;
+        }
+    }
+    }
+
+    return 0;
+}
@@ -0,0 +1,166 @@
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <cstdint>
+
+#include "../src/ESP32-HUB75-MatrixPanel-BeamRace.hpp"
+
+// Simulated scan clock for BeamRaceScheduler.
+//
+// The DMA engine outputs (absolute) row q during [q * ROW_NS, (q+1) * ROW_NS) and keeps looping over the same
+// single buffer. The encoder writes a new frame every FRAME_NS, one scan slot at a time, each write taking
+// write_ns (plus an optional one-off stall, i.e. being preempted). A refresh (slot 0 to slot ROWS-1) is torn
+// if it doesn't show the same frame on every row.
+//
+// g++ -o beam_race_sim.exe beam_race_sim.cpp
+
+struct Write {
+    uint16_t slot;
+    int version;
+    uint64_t start, end;
+};
+
+struct Result {
+    int torn_refreshes = 0;  // refreshes showing more than one frame
+    int rows_under_scan = 0; // writes overlapping the scanner reading the same slot
+    int late_rows = 0;       // as reported by the scheduler
+    uint64_t slept_ns = 0;   // blocked waiting for the start of the race
+    uint64_t spun_ns = 0;    // polling once started
+};
+
+static const int ROWS = 32;
+static const uint64_t ROW_NS = 480000;     // 256px x 8 planes + MSB repeats @ 8Mhz, roughly 65Hz refresh
+static const uint64_t FRAME_NS = 25000000; // matrix_task redraws every ~25ms
+static const uint64_t ISR_NS = 5000;       // EOF interrupt to task wake up
+
+Result simulate(bool beam_race, uint64_t write_ns, uint64_t stall_ns, int frames)
+{
+    std::vector<Write> writes;
+    Result res;
+
+    uint64_t now = 1234567; // don't start on a row boundary
+
+    for (int f = 1; f <= frames; f++)
+    {
+        BeamRaceScheduler scheduler(ROWS);
+        scheduler.begin(now / ROW_NS);
+
+        if (beam_race)
+        {
+            uint64_t wake = scheduler.startAt() * ROW_NS + ISR_NS;
+            if (wake > now)
+            {
+                res.slept_ns += wake - now;
+                now = wake;
+            }
+        }
+
+        while (!scheduler.done())
+        {
+            bool late = false;
+
+            if (beam_race)
+            {
+                BeamRaceScheduler::action_t action;
+                while ((action = scheduler.poll(now / ROW_NS)) == BeamRaceScheduler::ROW_WAIT)
+                {
+                    now += 1000; // 1us poll, like esp_rom_delay_us(1)
+                    res.spun_ns += 1000;
+                }
+
+                late = (action != BeamRaceScheduler::ROW_WRITE);
+            }
+
+            writes.push_back({scheduler.nextRow(), f, now, now + write_ns});
+            now += write_ns;
+
+            // one stall half way through the second frame
+            if (f == 2 && scheduler.nextRow() == ROWS / 2)
+                now += stall_ns;
+
+            scheduler.rowWritten(late);
+        }
+
+        res.late_rows += scheduler.lateRows();
+        now = (uint64_t)f * FRAME_NS + (now % 7919) * 1000; // next redraw, a bit of jitter
+    }
+
+    // Replay the scan and check which frame every row of every refresh showed
+    uint64_t last_q = (now / ROW_NS / ROWS + 2) * ROWS;
+
+    for (uint64_t pass = 0; pass * ROWS < last_q; pass++)
+    {
+        int first_shown = -1;
+        bool torn = false;
+
+        for (uint16_t slot = 0; slot < ROWS; slot++)
+        {
+            uint64_t vs = (pass * ROWS + slot) * ROW_NS, ve = vs + ROW_NS;
+            int shown = 0;
+
+            for (const Write &w : writes)
+            {
+                if (w.slot != slot)
+                    continue;
+
+                if (w.start < ve && w.end > vs)
+                    res.rows_under_scan++;
+                else if (w.end <= vs && w.version > shown)
+                    shown = w.version;
+            }
+
+            if (first_shown < 0)
+                first_shown = shown;
+            else if (shown != first_shown)
+                torn = true;
+        }
+
+        res.torn_refreshes += torn;
+    }
+
+    return res;
+}
+
+void report(const char *name, const Result &r, int frames)
+{
+    std::cout << std::left << std::setw(42) << name
+              << "torn refreshes: " << std::setw(4) << r.torn_refreshes
+              << "writes under scanner: " << std::setw(4) << r.rows_under_scan
+              << "late rows: " << std::setw(5) << r.late_rows
+              << "avg sleep: " << std::setw(6) << (r.slept_ns / frames / 1000) << "us  "
+              << "avg spin: " << (r.spun_ns / frames / 1000) << "us" << std::endl;
+}
+
+int main()
+{
+    const int frames = 200;
+    int failures = 0;
+
+    // Normal case, encoder ~6x quicker than the scan
+    Result ok = simulate(true, 80000, 0, frames);
+    report("beam race, 80us/row", ok, frames);
+    failures += (ok.torn_refreshes != 0 || ok.rows_under_scan != 0 || ok.late_rows != 0);
+
+    // Encoder quicker than the scan overall, but slow enough for the scanner to stay close behind
+    Result close = simulate(true, 400000, 0, frames);
+    report("beam race, 400us/row", close, frames);
+    failures += (close.torn_refreshes != 0 || close.rows_under_scan != 0 || close.late_rows != 0);
+
+    // Encoder slower than the scan - can't be won in a single buffer, but every tear must be reported
+    Result slow = simulate(true, 700000, 0, frames);
+    report("beam race, 700us/row (slower than scan)", slow, frames);
+    failures += (slow.torn_refreshes == 0 || slow.late_rows == 0);
+
+    // Preempted for 10ms half way through a frame - the scanner overtakes, which must be reported
+    Result stall = simulate(true, 80000, 10000000, frames);
+    report("beam race, 10ms stall mid-frame", stall, frames);
+    failures += (stall.rows_under_scan != 0);
+    failures += (stall.torn_refreshes == 0 || stall.late_rows == 0);
+
+    // What matrix_task did before - write rows with no regard for the scanner
+    Result naive = simulate(false, 80000, 0, frames);
+    report("no sync (reference)", naive, frames);
+
+    std::cout << (failures ? "FAIL" : "PASS") << std::endl;
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,45 @@
+#include <iostream>
+#include <iomanip>
+
+#include "../src/ESP32-HUB75-MatrixPanel-RGB565.hpp"
+
+// How many RGB565 levels survive at each colour depth (RGB565SourceLUT, used by HUB75_I2S_CFG::SOURCE_RGB565),
+// and what depth / DMA memory the source actually needs for a 256x64 chain.
+//
+// g++ -o source_depth.exe source_depth.cpp
+
+int main()
+{
+    const int width = 256, rows = 32;
+    int failures = 0;
+
+    for (bool cie : {true, false})
+    {
+        std::cout << (cie ? "CIE 1931" : "linear (NO_CIE1931)") << std::endl;
+
+        for (int depth = 4; depth <= 12; depth++)
+        {
+            std::cout << "  " << std::setw(2) << depth << " bits: red/blue " << std::setw(2) << (int)RGB565SourceLUT::distinctLevels(5, depth, cie)
+                      << "/32, green " << std::setw(2) << (int)RGB565SourceLUT::distinctLevels(6, depth, cie) << "/64" << std::endl;
+        }
+
+        int needed = RGB565SourceLUT::sourceDepthBits(8, cie);
+        std::cout << "  configured 8 bits -> " << needed << " bits, framebuffer " << width * rows * 8 * 2 << " -> " << width * rows * needed * 2 << " bytes" << std::endl;
+
+        // the tables must never go backwards
+        RGB565SourceLUT lut;
+        lut.build(8, cie);
+        for (uint16_t v = 1; v < 32; v++)
+            failures += lut.red(v << 11) < lut.red((v - 1) << 11);
+        for (uint16_t v = 1; v < 64; v++)
+            failures += lut.green(v << 5) < lut.green((v - 1) << 5);
+        failures += lut.blue(0x1F) != 255 || lut.green(0x07E0) != 255;
+    }
+
+    // CIE needs all 8 bits for the darkest 5-bit steps, linear gets away with 6
+    failures += RGB565SourceLUT::sourceDepthBits(8, true) != 8;
+    failures += RGB565SourceLUT::sourceDepthBits(8, false) != 6;
+
+    std::cout << (failures ? "FAIL" : "PASS") << std::endl;
+    return failures ? 1 : 0;
+}
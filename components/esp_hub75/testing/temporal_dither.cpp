@@ -0,0 +1,103 @@
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <algorithm>
+
+#define PIXEL_COLOR_DEPTH_BITS 8
+#define TEMPORAL_DITHER
+#include "../src/cie_luts.h"
+
+// Checks the TEMPORAL_DITHER encoding (DO_DITHERED_COMPENSATION in ESP32-HUB75-MatrixPanel-I2S-DMA.cpp):
+//  - every 8-bit input level averages out, over the 2x2 pattern and both phases, to the 12-bit LUT value at depth + 2 bits
+//  - RAM and host CPU cost of encoding a 256x64 frame: 8-bit single buffer vs. dithered 6-bit in two buffers
+//
+// g++ -O2 -o temporal_dither.exe temporal_dither.cpp
+
+static const uint8_t dither_threshold[2][2][2] = { { {0, 2}, {3, 1} }, { {3, 1}, {0, 2} } };
+
+static const int WIDTH = 256, ROWS = 32;
+
+static uint16_t dithered(uint8_t v, int depth, uint8_t threshold)
+{
+    uint16_t max_val = (1 << depth) - 1;
+    uint16_t q = lumConvTab_12bit[v] >> (10 - depth);
+    return std::min<uint16_t>((q >> 2) + ((q & 3) > threshold), max_val);
+}
+
+// Same bitplane packing as updateMatrixDMARowPair(), one colour channel per pixel is enough for timing
+static void encode(std::vector<uint16_t> &buf, const std::vector<uint8_t> &frame, int depth, int phase, bool dither)
+{
+    for (int row = 0; row < ROWS; row++)
+    {
+        for (int x = 0; x < WIDTH; x++)
+        {
+            uint8_t top = frame[row * WIDTH + x], bottom = frame[(row + ROWS) * WIDTH + x];
+            uint16_t t = dither ? dithered(top, depth, dither_threshold[phase][row & 1][x & 1]) : lumConvTab_8bit[top];
+            uint16_t b = dither ? dithered(bottom, depth, dither_threshold[phase][(row + ROWS) & 1][x & 1]) : lumConvTab_8bit[bottom];
+
+            for (int d = 0; d < depth; d++)
+            {
+                uint16_t &p = buf[(row * depth + d) * WIDTH + x];
+                p = (p & ~0x3F) | (((b >> d) & 1) << 3) | ((t >> d) & 1);
+            }
+        }
+    }
+}
+
+int main()
+{
+    int failures = 0;
+
+    for (int depth : {6, 7, 8})
+    {
+        double worst = 0;
+
+        for (int v = 0; v < 256; v++)
+        {
+            int sum = 0;
+            for (int phase = 0; phase < 2; phase++)
+                for (int y = 0; y < 2; y++)
+                    for (int x = 0; x < 2; x++)
+                        sum += dithered(v, depth, dither_threshold[phase][y][x]);
+
+            // target in units of the output LSB, the top level is clamped so exclude that from the check
+            double target = (lumConvTab_12bit[v] >> (10 - depth)) / 4.0;
+            double err = std::abs(sum / 8.0 - target);
+            if (target <= (1 << depth) - 1)
+                worst = std::max(worst, err);
+        }
+
+        std::cout << depth << "-bit + dither: worst average error " << worst << " LSB" << std::endl;
+        failures += (worst > 0);
+    }
+
+    std::vector<uint8_t> frame(WIDTH * ROWS * 2);
+    for (size_t i = 0; i < frame.size(); i++)
+        frame[i] = (i * 7) & 0xFF;
+
+    std::vector<uint16_t> buf8(WIDTH * ROWS * 8), buf6a(WIDTH * ROWS * 6), buf6b(WIDTH * ROWS * 6);
+    const int loops = 200;
+
+    auto t0 = std::chrono::steady_clock::now();
+    for (int i = 0; i < loops; i++)
+        encode(buf8, frame, 8, 0, false);
+    auto t1 = std::chrono::steady_clock::now();
+    for (int i = 0; i < loops; i++)
+    {
+        encode(buf6a, frame, 6, 0, true);
+        encode(buf6b, frame, 6, 1, true);
+    }
+    auto t2 = std::chrono::steady_clock::now();
+
+    double us8 = std::chrono::duration<double, std::micro>(t1 - t0).count() / loops;
+    double us6 = std::chrono::duration<double, std::micro>(t2 - t1).count() / loops;
+
+    std::cout << "8-bit, single buffer:   " << std::setw(7) << buf8.size() * 2 << " bytes, encode " << us8 << "us/frame (host)" << std::endl;
+    std::cout << "6-bit dithered, 2 bufs: " << std::setw(7) << (buf6a.size() + buf6b.size()) * 2 << " bytes, encode " << us6 << "us/frame (host), x" << us6 / us8 << std::endl;
+
+    std::cout << (failures ? "FAIL" : "PASS") << std::endl;
+    return failures ? 1 : 0;
+}
@@ -157,8 +157,13 @@ def generate_header():
         validate_lut(lut, depth)
 
         max_val = (1 << depth) - 1
+        # TEMPORAL_DITHER needs the extra precision of the 12-bit table whatever the colour depth
+        guard = f"!defined(PIXEL_COLOR_DEPTH_BITS) || PIXEL_COLOR_DEPTH_BITS == {depth}"
+        if depth == 12:
+            guard += " || defined(TEMPORAL_DITHER)"
+
         header += f"""
-#if !defined(PIXEL_COLOR_DEPTH_BITS) || PIXEL_COLOR_DEPTH_BITS == {depth}
+#if {guard}
 // {depth}-bit CIE 1931 lookup table
 // Maps 8-bit input (0-255) to {depth}-bit output (0-{max_val})
 static const {dtype} lumConvTab_{depth}bit[256] = {{
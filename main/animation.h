@@ -0,0 +1,62 @@
+#ifndef ANIMATION_H
+#define ANIMATION_H
+
+#include <stdint.h>
+
+// --- Fixed Point ---
+// Animated positions are kept in 1/256ths of a pixel, speeds in 1/256ths of a pixel per second
+#define ANIM_SHIFT 8
+#define ANIM_ONE (1 << ANIM_SHIFT)
+#define ANIM_FIX(x) ((int32_t)((x) * ANIM_ONE))
+
+// --- Speeds ---
+// What the old per-frame steps came to at 40fps
+#define SPONSOR_SPEED      ANIM_FIX(80)  // 2px a frame
+#define ZOOM_SPEED         ANIM_FIX(3.2) // 0.08x a frame
+#define PAC_SPEED          ANIM_FIX(48)  // 1.2px a frame
+#define PAC_POWER_SPEED    ANIM_FIX(60)  // 1.5px a frame
+#define GHOST_SPEED        ANIM_FIX(64)  // 1.6px a frame
+#define GHOST_SCARED_SPEED ANIM_FIX(32)  // 0.8px a frame
+#define EYES_SPEED         ANIM_FIX(240) // 6px a frame
+
+// The ticker jumps a whole step at a time rather than moving every frame, so the dashboard is drawn
+// once a step: 40 times a second, 80px a second as before
+#define TICKER_STEP_PX 2
+#define TICKER_STEP_MS 25
+
+// Something moving along one axis, advanced by elapsed time rather than once a frame. The part of
+// each step too small to show up in the position is carried over to the next, so where it gets to
+// after a given time doesn't depend on how that time was split into frames: 20fps, 60fps, or a
+// frame held up by a TLS handshake all land on the same sub-pixel.
+class Motion {
+public:
+    Motion() {}
+    explicit Motion(int32_t fix) : pos(fix) {}
+
+    void set(int32_t fix) { pos = fix; rem = 0; }
+
+    // Move at speed (1/256 px per second) for dtMs
+    void advance(int32_t speed, uint32_t dtMs) {
+        int64_t travel = (int64_t)speed * dtMs + rem;
+        pos += (int32_t)(travel / 1000);
+        rem = (int32_t)(travel % 1000);
+    }
+
+    // Jump by a distance, keeping the sub-pixel progress (handing over to the next ticker message, ...)
+    void offset(int32_t fix) { pos += fix; }
+
+    // Keep within 0..length, for going round a loop
+    void wrap(int32_t length) {
+        pos %= length;
+        if (pos < 0) pos += length;
+    }
+
+    int32_t fix() const { return pos; }
+    int pixel() const { return pos >> ANIM_SHIFT; } // Rounds down, negatives included
+
+private:
+    int32_t pos = 0;
+    int32_t rem = 0; // Carried travel, in 1/256 px * 1/1000 s
+};
+
+#endif // ANIMATION_H
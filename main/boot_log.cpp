@@ -0,0 +1,18 @@
+#include "boot_log.h"
+#include "esp_timer.h"
+#include <stdio.h>
+#include <atomic>
+
+static const char *const phaseNames[BOOT_PHASE_COUNT] = {
+    "first pixel",
+    "IP acquired",
+    "time synced",
+    "first data"
+};
+
+static std::atomic<bool> reached[BOOT_PHASE_COUNT];
+
+void boot_mark(BootPhase phase) {
+    if (reached[phase].load(std::memory_order_relaxed) || reached[phase].exchange(true)) return;
+    printf("BOOT: %s at %lu ms\n", phaseNames[phase], (unsigned long)(esp_timer_get_time() / 1000));
+}
@@ -0,0 +1,17 @@
+#ifndef BOOT_LOG_H
+#define BOOT_LOG_H
+
+// --- Boot Phases ---
+// Milestones between power on and a fully live board, logged once each with the time since boot
+enum BootPhase {
+    BOOT_FIRST_PIXEL, // First frame sent to the panel
+    BOOT_IP,          // WiFi up with an address
+    BOOT_TIME_SYNCED, // SNTP has set the clock
+    BOOT_FIRST_DATA,  // First poll that TBA answered
+    BOOT_PHASE_COUNT
+};
+
+// Safe from any task, only the first call for a phase logs
+void boot_mark(BootPhase phase);
+
+#endif // BOOT_LOG_H
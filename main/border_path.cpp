@@ -0,0 +1,19 @@
+#include "border_path.h"
+
+void BorderPath::build(int width, int height, int inset) {
+    int x0 = inset, y0 = inset;
+    int x1 = width - 1 - inset, y1 = height - 1 - inset;
+    int across = x1 - x0, down = y1 - y0;
+
+    points.clear();
+    points.reserve(2 * (across + down));
+
+    corners[0] = 0;
+    for (int i = 0; i < across; i++) points.push_back({(int16_t)(x0 + i), (int16_t)y0, PATH_RIGHT}); // Top
+    corners[1] = length();
+    for (int i = 0; i < down; i++)   points.push_back({(int16_t)x1, (int16_t)(y0 + i), PATH_DOWN});  // Right
+    corners[2] = length();
+    for (int i = 0; i < across; i++) points.push_back({(int16_t)(x1 - i), (int16_t)y1, PATH_LEFT});  // Bottom
+    corners[3] = length();
+    for (int i = 0; i < down; i++)   points.push_back({(int16_t)x0, (int16_t)(y1 - i), PATH_UP});    // Left
+}
@@ -0,0 +1,52 @@
+#ifndef BORDER_PATH_H
+#define BORDER_PATH_H
+
+#include <stdint.h>
+#include <vector>
+
+// Which way the path runs at a point, going forwards (clockwise)
+enum PathDir {
+    PATH_RIGHT,
+    PATH_DOWN,
+    PATH_LEFT,
+    PATH_UP
+};
+
+struct PathPoint {
+    int16_t x, y;
+    uint8_t dir; // PathDir
+};
+
+// The rail round the edge of the display that Pac-Man and the ghosts run on, one entry per pixel step,
+// clockwise from the top left corner. Built once for the panel size, so finding where something is
+// comes down to a wrap and a table lookup.
+class BorderPath {
+public:
+    // Rectangle inset from the edges of a width x height display
+    void build(int width, int height, int inset);
+
+    int length() const { return (int)points.size(); }
+
+    // Any step count, negative or past the end, back onto the loop
+    int wrap(int p) const {
+        p %= length();
+        return (p < 0) ? p + length() : p;
+    }
+
+    const PathPoint &at(int p) const { return points[wrap(p)]; }
+
+    // Steps between two points, the shorter way round
+    int distance(int a, int b) const {
+        int d = wrap(a - b);
+        return (d > length() / 2) ? length() - d : d;
+    }
+
+    // Step at which each corner is reached: top left, top right, bottom right, bottom left
+    int corner(int i) const { return corners[i]; }
+
+private:
+    std::vector<PathPoint> points;
+    int corners[4] = {};
+};
+
+#endif // BORDER_PATH_H
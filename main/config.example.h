@@ -3,8 +3,11 @@
 
 // The Blue Alliance API
 #define TBA_KEY "YOUR_TBA_API_KEY_HERE"
-// Note: Code was using http to avoid SSL issues
-#define TBA_URL "http://www.thebluealliance.com/api/v3/team/frc5459/event/2025mabos/matches/simple"
+// HTTPS, the certificate bundle takes care of TBA's certificate (and the async client needs it)
+#define TBA_URL "https://www.thebluealliance.com/api/v3/team/frc5459/event/2025mabos/matches/simple"
+// Push updates (optional): register http://<board ip>/tba as a webhook on your TBA account page with
+// this secret. Leave it out to only poll.
+#define TBA_WEBHOOK_SECRET "YOUR_WEBHOOK_SECRET"
 
 // WiFi Credentials (Static Fallback)
 #define WIFI_SSID "YOUR_WIFI_SSID"
@@ -0,0 +1,164 @@
+#include "display_layers.h"
+#include <string.h>
+#include <algorithm>
+
+static bool intersect(const LayerRect &a, const LayerRect &b, LayerRect &out) {
+    int16_t x0 = std::max(a.x, b.x);
+    int16_t y0 = std::max(a.y, b.y);
+    int16_t x1 = std::min(a.x + a.w, b.x + b.w);
+    int16_t y1 = std::min(a.y + a.h, b.y + b.h);
+    if (x1 <= x0 || y1 <= y0) return false;
+    out = {x0, y0, (int16_t)(x1 - x0), (int16_t)(y1 - y0)};
+    return true;
+}
+
+static LayerRect boundingBox(const LayerRect &a, const LayerRect &b) {
+    int16_t x0 = std::min(a.x, b.x);
+    int16_t y0 = std::min(a.y, b.y);
+    int16_t x1 = std::max(a.x + a.w, b.x + b.w);
+    int16_t y1 = std::max(a.y + a.h, b.y + b.h);
+    return {x0, y0, (int16_t)(x1 - x0), (int16_t)(y1 - y0)};
+}
+
+static bool contains(const LayerRect &outer, const LayerRect &inner) {
+    return inner.x >= outer.x && inner.y >= outer.y &&
+           inner.x + inner.w <= outer.x + outer.w && inner.y + inner.h <= outer.y + outer.h;
+}
+
+// --- LayerCanvas ---
+
+LayerCanvas::LayerCanvas(const LayerRect &clip) : GFXcanvas16(clip.w, clip.h), clip(clip) {
+    // Adafruit_GFX skips whole characters past width()/height(), which have to be in screen
+    // coordinates for text to be drawn at all. drawPixel() does the real clipping.
+    _width = clip.x + clip.w;
+    _height = clip.y + clip.h;
+    setTextWrap(false);
+}
+
+void LayerCanvas::drawPixel(int16_t x, int16_t y, uint16_t color) {
+    x -= clip.x;
+    y -= clip.y;
+    if (x < 0 || y < 0 || x >= clip.w || y >= clip.h) return;
+    getBuffer()[y * clip.w + x] = color;
+}
+
+// --- DisplayLayer ---
+
+DisplayLayer::DisplayLayer(Compositor *owner, const LayerRect &clip, int z)
+    : canvas(new LayerCanvas(clip)), owner(owner), z(z) {}
+
+void DisplayLayer::setVisible(bool v) {
+    if (v == visible) return;
+    visible = v;
+    owner->addDirty(canvas->clip); // Whatever it covered (or now covers) has to be redone
+}
+
+void DisplayLayer::markDirty() {
+    markDirty(canvas->clip.x, canvas->clip.y, canvas->clip.w, canvas->clip.h);
+}
+
+void DisplayLayer::markDirty(int16_t x, int16_t y, int16_t w, int16_t h) {
+    LayerRect r;
+    if (!visible || !intersect(canvas->clip, {x, y, w, h}, r)) return;
+    dirty = true;
+    owner->addDirty(r);
+}
+
+// --- Compositor ---
+
+Compositor::Compositor(GFXcanvas16 *target, int16_t width, int16_t height)
+    : target(target), width(width), height(height) {}
+
+DisplayLayer *Compositor::addLayer(int16_t x, int16_t y, int16_t w, int16_t h, int z) {
+    DisplayLayer *layer = new DisplayLayer(this, {x, y, w, h}, z);
+
+    auto pos = std::upper_bound(layers.begin(), layers.end(), layer,
+                                [](const DisplayLayer *a, const DisplayLayer *b) { return a->z < b->z; });
+    layers.insert(pos, layer);
+
+    layer->canvas->fillScreen(0);
+    layer->markDirty();
+    return layer;
+}
+
+void Compositor::addDirty(LayerRect r) {
+    if (!intersect(r, {0, 0, width, height}, r)) return;
+
+    // Fold in anything it touches, repeating as the merged rectangle grows
+    bool merged = true;
+    while (merged) {
+        merged = false;
+        for (int i = 0; i < dirtyCount; i++) {
+            LayerRect overlap;
+            if (intersect(r, dirtyRects[i], overlap)) {
+                r = boundingBox(r, dirtyRects[i]);
+                dirtyRects[i] = dirtyRects[--dirtyCount];
+                merged = true;
+                break;
+            }
+        }
+    }
+
+    if (dirtyCount == MAX_DIRTY_RECTS) {
+        // Out of slots, collapse the lot into one
+        for (int i = 0; i < dirtyCount; i++) r = boundingBox(r, dirtyRects[i]);
+        dirtyCount = 0;
+    }
+
+    dirtyRects[dirtyCount++] = r;
+}
+
+void Compositor::compositeRect(const LayerRect &r) {
+    // Nothing under the topmost opaque layer covering the whole region can show, start from there
+    int first = 0;
+    bool covered = false;
+    for (int i = layers.size() - 1; i >= 0; i--) {
+        DisplayLayer *l = layers[i];
+        if (l->visible && !l->keyed && contains(l->canvas->clip, r)) {
+            first = i;
+            covered = true;
+            break;
+        }
+    }
+
+    uint16_t *dst = target->getBuffer();
+    if (!covered) {
+        for (int y = r.y; y < r.y + r.h; y++) {
+            memset(&dst[y * width + r.x], 0, r.w * sizeof(uint16_t));
+        }
+    }
+
+    for (size_t i = first; i < layers.size(); i++) {
+        DisplayLayer *l = layers[i];
+        const LayerRect &clip = l->canvas->clip;
+        LayerRect part;
+        if (!l->visible || !intersect(clip, r, part)) continue;
+
+        const uint16_t *src = l->canvas->getBuffer();
+        for (int y = part.y; y < part.y + part.h; y++) {
+            const uint16_t *s = &src[(y - clip.y) * clip.w + (part.x - clip.x)];
+            uint16_t *d = &dst[y * width + part.x];
+
+            if (!l->keyed) {
+                memcpy(d, s, part.w * sizeof(uint16_t));
+            } else {
+                for (int x = 0; x < part.w; x++) {
+                    if (s[x] != l->colorKey) d[x] = s[x];
+                }
+            }
+        }
+    }
+}
+
+uint32_t Compositor::composite() {
+    uint32_t pixels = 0;
+
+    for (int i = 0; i < dirtyCount; i++) {
+        compositeRect(dirtyRects[i]);
+        pixels += dirtyRects[i].w * dirtyRects[i].h;
+    }
+
+    dirtyCount = 0;
+    for (DisplayLayer *l : layers) l->dirty = false;
+    return pixels;
+}
@@ -0,0 +1,76 @@
+#ifndef DISPLAY_LAYERS_H
+#define DISPLAY_LAYERS_H
+
+#include <stdint.h>
+#include <vector>
+#include "Adafruit_GFX.h"
+
+// Max separate dirty regions per frame before they're merged into one bounding box
+#define MAX_DIRTY_RECTS 8
+
+struct LayerRect {
+    int16_t x, y, w, h;
+};
+
+class Compositor;
+
+// Canvas covering just its layer's clip rectangle. Drawn to in screen coordinates,
+// anything outside the rectangle is clipped.
+class LayerCanvas : public GFXcanvas16 {
+public:
+    LayerCanvas(const LayerRect &clip);
+    void drawPixel(int16_t x, int16_t y, uint16_t color);
+
+    const LayerRect clip;
+};
+
+class DisplayLayer {
+public:
+    LayerCanvas *canvas;
+
+    // Pixels of this colour let the layers underneath show through
+    void setColorKey(uint16_t key) { keyed = true; colorKey = key; }
+
+    void setVisible(bool v);
+    bool isVisible() const { return visible; }
+
+    // Content has changed and has to be recomposited - all of it, or just part of the clip rectangle
+    void markDirty();
+    void markDirty(int16_t x, int16_t y, int16_t w, int16_t h);
+    bool isDirty() const { return dirty; }
+
+private:
+    friend class Compositor;
+    DisplayLayer(Compositor *owner, const LayerRect &clip, int z);
+
+    Compositor *owner;
+    int z;
+    bool keyed = false;
+    uint16_t colorKey = 0;
+    bool visible = true;
+    bool dirty = false;
+};
+
+// Stacks layers by z-order (highest on top) into a target canvas, only redoing the regions that changed.
+class Compositor {
+public:
+    Compositor(GFXcanvas16 *target, int16_t width, int16_t height);
+
+    DisplayLayer *addLayer(int16_t x, int16_t y, int16_t w, int16_t h, int z);
+
+    // Bring the target up to date, returns the number of pixels recomposited (0 = target unchanged)
+    uint32_t composite();
+
+private:
+    friend class DisplayLayer;
+    void addDirty(LayerRect r);
+    void compositeRect(const LayerRect &r);
+
+    GFXcanvas16 *target;
+    int16_t width, height;
+    std::vector<DisplayLayer *> layers; // Sorted by z, bottom first
+    LayerRect dirtyRects[MAX_DIRTY_RECTS];
+    int dirtyCount = 0;
+};
+
+#endif // DISPLAY_LAYERS_H
@@ -0,0 +1,137 @@
+#include "display_list.h"
+#include <stdio.h>
+
+static bool overlaps(const LayerRect &a, const LayerRect &b) {
+    return a.x < b.x + b.w && b.x < a.x + a.w && a.y < b.y + b.h && b.y < a.y + a.h;
+}
+
+static LayerRect boundingBox(const LayerRect &a, const LayerRect &b) {
+    int16_t x0 = (a.x < b.x) ? a.x : b.x;
+    int16_t y0 = (a.y < b.y) ? a.y : b.y;
+    int16_t x1 = (a.x + a.w > b.x + b.w) ? a.x + a.w : b.x + b.w;
+    int16_t y1 = (a.y + a.h > b.y + b.h) ? a.y + a.h : b.y + b.h;
+    return {x0, y0, (int16_t)(x1 - x0), (int16_t)(y1 - y0)};
+}
+
+bool DisplayList::Command::operator==(const Command &o) const {
+    if (type != o.type || color != o.color || font != o.font || bitmap != o.bitmap) return false;
+    if (bounds.x != o.bounds.x || bounds.y != o.bounds.y || bounds.w != o.bounds.w || bounds.h != o.bounds.h) return false;
+    if (glyphs.size() != o.glyphs.size()) return false;
+
+    for (size_t i = 0; i < glyphs.size(); i++) {
+        if (glyphs[i].x != o.glyphs[i].x || glyphs[i].y != o.glyphs[i].y || glyphs[i].c != o.glyphs[i].c) return false;
+    }
+    return true;
+}
+
+// --- Recording ---
+
+void DisplayList::print(const char *s) {
+    Command cmd = {CMD_TEXT, {0, 0, 0, 0}, textColor, font, nullptr, {}};
+
+    for (; *s; s++) {
+        char c = *s;
+        LayerRect box;
+
+        if (!font) {
+            // Classic 6x8 font, cursor is the top left corner
+            if (c == '\n') { cursorX = 0; cursorY += 8; continue; }
+            if (c == '\r') continue;
+
+            box = {cursorX, cursorY, 6, 8};
+            if (c != ' ') cmd.glyphs.push_back({cursorX, cursorY, c});
+            cursorX += 6;
+        } else {
+            // GFX font, cursor is on the baseline
+            if (c == '\n') { cursorX = 0; cursorY += font->yAdvance; continue; }
+            if (c == '\r' || (uint8_t)c < font->first || (uint8_t)c > font->last) continue;
+
+            const GFXglyph *g = &font->glyph[(uint8_t)c - font->first];
+            box = {(int16_t)(cursorX + g->xOffset), (int16_t)(cursorY + g->yOffset), g->width, g->height};
+            if (g->width > 0 && g->height > 0) cmd.glyphs.push_back({cursorX, cursorY, c});
+            cursorX += g->xAdvance;
+        }
+
+        if (box.w > 0 && box.h > 0) {
+            cmd.bounds = (cmd.bounds.w == 0) ? box : boundingBox(cmd.bounds, box);
+        }
+    }
+
+    if (!cmd.glyphs.empty()) commands.push_back(cmd);
+}
+
+void DisplayList::print(char c) {
+    char s[2] = {c, 0};
+    print(s);
+}
+
+void DisplayList::print(int n) {
+    char s[12];
+    snprintf(s, sizeof(s), "%d", n);
+    print(s);
+}
+
+void DisplayList::drawFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color) {
+    fillRect(x, y, w, 1, color);
+}
+
+void DisplayList::drawFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color) {
+    fillRect(x, y, 1, h, color);
+}
+
+void DisplayList::fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) {
+    if (w <= 0 || h <= 0) return;
+    commands.push_back({CMD_FILL_RECT, {x, y, w, h}, color, nullptr, nullptr, {}});
+}
+
+void DisplayList::drawRGBBitmap(int16_t x, int16_t y, const uint16_t *bitmap, int16_t w, int16_t h) {
+    if (w <= 0 || h <= 0) return;
+    commands.push_back({CMD_BITMAP, {x, y, w, h}, 0, nullptr, bitmap, {}});
+}
+
+// --- Playback ---
+
+void DisplayList::replay(GFXcanvas16 *canvas, const std::vector<LayerRect> &areas) const {
+    for (const Command &cmd : commands) {
+        bool visible = false;
+        for (const LayerRect &a : areas) {
+            if (overlaps(cmd.bounds, a)) { visible = true; break; }
+        }
+        if (!visible) continue;
+
+        switch (cmd.type) {
+            case CMD_TEXT:
+                canvas->setFont(cmd.font);
+                for (const Glyph &g : cmd.glyphs) {
+                    canvas->drawChar(g.x, g.y, g.c, cmd.color, cmd.color, 1); // bg == color: no background
+                }
+                break;
+            case CMD_FILL_RECT:
+                canvas->fillRect(cmd.bounds.x, cmd.bounds.y, cmd.bounds.w, cmd.bounds.h, cmd.color);
+                break;
+            case CMD_BITMAP:
+                canvas->drawRGBBitmap(cmd.bounds.x, cmd.bounds.y, cmd.bitmap, cmd.bounds.w, cmd.bounds.h);
+                break;
+        }
+    }
+}
+
+void DisplayList::diff(const DisplayList &from, const DisplayList &to, std::vector<LayerRect> &changed) {
+    std::vector<bool> matched(from.commands.size(), false);
+
+    for (const Command &cmd : to.commands) {
+        bool found = false;
+        for (size_t i = 0; i < from.commands.size(); i++) {
+            if (!matched[i] && from.commands[i] == cmd) {
+                matched[i] = true;
+                found = true;
+                break;
+            }
+        }
+        if (!found) changed.push_back(cmd.bounds); // New, or drawn differently
+    }
+
+    for (size_t i = 0; i < from.commands.size(); i++) {
+        if (!matched[i]) changed.push_back(from.commands[i].bounds); // Gone
+    }
+}
@@ -0,0 +1,66 @@
+#ifndef DISPLAY_LIST_H
+#define DISPLAY_LIST_H
+
+#include <stdint.h>
+#include <vector>
+#include "Adafruit_GFX.h"
+#include "display_layers.h"
+
+// Records draw calls (with the same names as Adafruit_GFX) instead of drawing them. Text is laid out
+// glyph by glyph when it's recorded, so replaying it is just a drawChar per glyph with no cursor or
+// font metric work. Every command knows its screen bounds, which is what lets replay skip anything
+// outside the area being redrawn and diff find what changed between two lists.
+class DisplayList {
+public:
+    void clear() { commands.clear(); }
+    size_t size() const { return commands.size(); }
+
+    // --- Recording ---
+    void setFont(const GFXfont *f) { font = f; }
+    void setTextColor(uint16_t c) { textColor = c; }
+    void setCursor(int16_t x, int16_t y) { cursorX = x; cursorY = y; }
+    void print(const char *s);
+    void print(char c);
+    void print(int n);
+    void drawFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color);
+    void drawFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color);
+    void fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color);
+    void drawRGBBitmap(int16_t x, int16_t y, const uint16_t *bitmap, int16_t w, int16_t h);
+
+    // --- Playback ---
+    // Draw the commands that overlap any of the given areas
+    void replay(GFXcanvas16 *canvas, const std::vector<LayerRect> &areas) const;
+
+    // Areas drawn differently by the two lists - whatever one has that the other doesn't
+    static void diff(const DisplayList &from, const DisplayList &to, std::vector<LayerRect> &changed);
+
+private:
+    enum CommandType {
+        CMD_TEXT,
+        CMD_FILL_RECT, // Lines are one pixel high / wide rects
+        CMD_BITMAP
+    };
+
+    struct Glyph {
+        int16_t x, y;
+        char c;
+    };
+
+    struct Command {
+        CommandType type;
+        LayerRect bounds;
+        uint16_t color;
+        const GFXfont *font;
+        const uint16_t *bitmap;
+        std::vector<Glyph> glyphs;
+
+        bool operator==(const Command &o) const;
+    };
+
+    std::vector<Command> commands;
+    const GFXfont *font = nullptr;
+    uint16_t textColor = 0xFFFF;
+    int16_t cursorX = 0, cursorY = 0;
+};
+
+#endif // DISPLAY_LIST_H
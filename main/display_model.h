@@ -0,0 +1,78 @@
+#ifndef DISPLAY_MODEL_H
+#define DISPLAY_MODEL_H
+
+#include <stdint.h>
+#include <time.h>
+#include <atomic>
+
+// --- Data Structures ---
+struct MatchEntry {
+    char type;    // 'Q' or 'P'
+    int number;
+    uint16_t color; // 0xF800 (Red) or 0x001F (Blue)
+    time_t estTime; // Estimated match time (Unix timestamp)
+};
+
+struct GameScore {
+    int matchNum;
+    int autoFuel;
+    int autoClimb;
+    int teleFuel;
+    int teleClimb;
+    int foulPointsAwarded;
+    int totalScore;
+    bool fuelRP;
+    bool towerRP;
+    char type; // 'Q' or 'P', numbered the same way as MatchEntry
+};
+
+// Everything the display shows that comes from TBA (or the mock data), copied about as one plain struct
+struct DisplayModel {
+    uint32_t version;  // Bumped on every publish
+    GameScore matchHistory[12];
+    int matchesCompleted;
+    MatchEntry schedule[3];
+    int currentlyPlaying;
+    char nextEventName[32];
+    time_t nextEventDate;
+    time_t nextEventEnd; // Its last day (midnight, like nextEventDate)
+};
+
+// Hands DisplayModel snapshots from the network task to matrix_task without locks (triple buffer).
+//
+// The writer edits a private working copy and publish() swaps a finished copy into the middle slot.
+// read() swaps the middle slot out if it's newer than what the reader has, so it never blocks and never
+// sees a half written model. The snapshot stays put until the reader's next read().
+//
+// One writer and one reader at a time.
+class DisplayModelStore {
+public:
+    // --- Writer ---
+    DisplayModel &edit() { return working; }
+
+    void publish() {
+        working.version++;
+        slots[back] = working;
+        back = middle.exchange(back | FRESH, std::memory_order_acq_rel) & INDEX_MASK;
+    }
+
+    // --- Reader ---
+    const DisplayModel &read() {
+        if (middle.load(std::memory_order_acquire) & FRESH) {
+            front = middle.exchange(front, std::memory_order_acq_rel) & INDEX_MASK;
+        }
+        return slots[front];
+    }
+
+private:
+    static const uint8_t FRESH = 0x80;
+    static const uint8_t INDEX_MASK = 0x03;
+
+    DisplayModel working = {};
+    DisplayModel slots[3] = {};
+    uint8_t back = 0;                // Writer's
+    uint8_t front = 1;               // Reader's
+    std::atomic<uint8_t> middle{2};  // Last published, FRESH until the reader takes it
+};
+
+#endif // DISPLAY_MODEL_H
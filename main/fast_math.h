@@ -0,0 +1,65 @@
+#ifndef FAST_MATH_H
+#define FAST_MATH_H
+
+#include <stdint.h>
+
+// Integer stand-ins for the libm calls the display animations used to make (sin, fmod, float lerps).
+// The S3 only has a single precision FPU, and a table lookup beats even that. Angles go 0..255 for a
+// full turn, the same as the FastLED sin8() family the AuroraDemo effects are written against.
+
+// --- 8 Bit Waves ---
+
+// 127 * sin() over a quarter turn, 0..64 inclusive
+static const uint8_t SIN8_QUARTER[65] = {
+      0,   3,   6,   9,  12,  16,  19,  22,  25,  28,  31,  34,  37,
+     40,  43,  46,  49,  51,  54,  57,  60,  63,  65,  68,  71,  73,
+     76,  78,  81,  83,  85,  88,  90,  92,  94,  96,  98, 100, 102,
+    104, 106, 107, 109, 111, 112, 113, 115, 116, 117, 118, 120, 121,
+    122, 122, 123, 124, 125, 125, 126, 126, 126, 127, 127, 127, 127,
+};
+
+// Sine, 128 at theta 0, peaking at 255 (theta 64) and bottoming out at 1 (theta 192)
+static inline uint8_t sin8(uint8_t theta) {
+    uint8_t i = theta & 0x3F;
+    uint8_t quarter = theta >> 6;
+    uint8_t v = SIN8_QUARTER[(quarter & 1) ? 64 - i : i];
+    return (quarter & 2) ? 128 - v : 128 + v;
+}
+
+static inline uint8_t cos8(uint8_t theta) { return sin8(theta + 64); }
+
+// i * scale / 256, with scale 255 giving back i
+static inline uint8_t scale8(uint8_t i, uint8_t scale) {
+    return ((uint16_t)i * (1 + scale)) >> 8;
+}
+
+// A sine wave between lowest and highest, one cycle every periodMs
+static inline uint8_t beatsin8(uint32_t ms, uint32_t periodMs, uint8_t lowest, uint8_t highest) {
+    uint8_t theta = (uint8_t)(((ms % periodMs) << 8) / periodMs);
+    return lowest + scale8(sin8(theta), highest - lowest);
+}
+
+// --- Q16.16 ---
+typedef int32_t q16_t;
+
+#define Q16_SHIFT 16
+#define Q16_ONE (1 << Q16_SHIFT)
+
+static inline q16_t q16Mul(q16_t a, q16_t b) {
+    return (q16_t)(((int64_t)a * b) >> Q16_SHIFT);
+}
+
+// a at t = 0, b at t = Q16_ONE
+static inline int32_t q16Lerp(int32_t a, int32_t b, q16_t t) {
+    return a + (int32_t)(((int64_t)(b - a) * t) >> Q16_SHIFT);
+}
+
+// --- Wrapping ---
+
+// (v + step) kept within 0..length, for counters going round a loop either way
+static inline int32_t wrapAdd(int32_t v, int32_t step, int32_t length) {
+    v = (v + step) % length;
+    return (v < 0) ? v + length : v;
+}
+
+#endif // FAST_MATH_H
@@ -7,6 +7,8 @@
 #include <time.h>
 #include "ESP32-HUB75-MatrixPanel-I2S-DMA.h"
 #include "Adafruit_GFX.h"
+#include "display_model.h"
+#include "animation.h"
 
 // --- Constants & Colors ---
 #define GHOST_BLINKY 0xF800 // Red
@@ -15,25 +17,6 @@
 #define GHOST_CLYDE  0xFB20 // Orange
 
 // --- Data Structures ---
-struct MatchEntry {
-    char type;    // 'Q' or 'P'
-    int number;
-    uint16_t color; // 0xF800 (Red) or 0x001F (Blue)
-    time_t estTime; // Estimated match time (Unix timestamp)
-};
-
-struct GameScore {
-    int matchNum;
-    int autoFuel;
-    int autoClimb;
-    int teleFuel;
-    int teleClimb;
-    int foulPointsAwarded;
-    int totalScore;
-    bool fuelRP;
-    bool towerRP;
-};
-
 struct LastMatchData {
     int matchNum;
     int redScore;
@@ -49,13 +32,11 @@ extern MatrixPanel_I2S_DMA *matrix;
 extern GFXcanvas16 *canvas_dev;
 
 // Data Queues/History
-extern std::vector<std::string> tickerQueue;
-extern GameScore matchHistory[12];
-extern int matchesCompleted;
-extern MatchEntry schedule[3];
-extern int currentlyPlaying;
 extern LastMatchData lastMatch;
 
+// Schedule, match history and next event - written by tba_api_task, read by matrix_task
+extern DisplayModelStore displayModel;
+
 // Pac-Man Game State
 enum GhostState {
     GHOST_ALIVE,
@@ -65,16 +46,12 @@ enum GhostState {
 
 extern bool borderActive;
 extern uint32_t lastBorderStartTime;
-extern float pacPos;
-extern float ghostPos[4];
-extern float worldSpeed;
+extern Motion pacPos;
+extern Motion ghostPos[4];
+extern int32_t worldSpeed; // 1/256 px per second
 extern bool powerMode;
 extern uint32_t powerStartTime;
 extern GhostState ghostState[4];
 extern uint32_t winStartTime;
 
-// Event Schedule
-extern std::string nextEventName;
-extern time_t nextEventDate;
-
 #endif // GLOBALS_H
@@ -0,0 +1,169 @@
+#include "gzip_stream.h"
+#include "rom/miniz.h"
+#include "esp_rom_crc.h"
+#include "esp_heap_caps.h"
+#include "esp_timer.h"
+#include <stdio.h>
+
+#define GZIP_FTEXT    0x01
+#define GZIP_FHCRC    0x02
+#define GZIP_FEXTRA   0x04
+#define GZIP_FNAME    0x08
+#define GZIP_FCOMMENT 0x10
+
+struct GzipMemory {
+    tinfl_decompressor inflator;
+    uint8_t window[TINFL_LZ_DICT_SIZE];
+};
+
+static GzipMemory *memory = NULL;
+
+size_t GzipStream::memoryBytes() {
+    return sizeof(GzipMemory);
+}
+
+void GzipStream::begin() {
+    state = G_ERROR;
+    if (!memory) {
+        memory = (GzipMemory *)heap_caps_malloc_prefer(sizeof(GzipMemory), 2, MALLOC_CAP_SPIRAM, MALLOC_CAP_8BIT);
+        if (!memory) {
+            printf("GZIP: Couldn't allocate %u bytes\n", (unsigned)sizeof(GzipMemory));
+            return;
+        }
+    }
+    tinfl_init(&memory->inflator);
+
+    state = G_HEADER;
+    flags = 0;
+    have = 0;
+    skip = 0;
+    crc = 0;
+    windowPos = 0;
+    bytesIn = 0;
+    bytesOut = 0;
+    inflateUs = 0;
+}
+
+bool GzipStream::feed(const char *data, int len, JsonStream &json) {
+    const uint8_t *in = (const uint8_t *)data;
+    bytesIn += len;
+
+    while (len > 0 && state != G_ERROR) {
+        if (state == G_DEFLATE) {
+            int used = inflate(in, len, json);
+            in += used;
+            len -= used;
+        } else if (state == G_TRAILER) {
+            bytes[have++] = *in++;
+            len--;
+            if (have == 8) checkTrailer();
+        } else if (state == G_DONE) {
+            state = G_ERROR; // Only the one member
+        } else {
+            if (!headerByte(*in++)) state = G_ERROR;
+            len--;
+        }
+    }
+    return state != G_ERROR;
+}
+
+// --- Header: magic, method, flags, mtime, xfl, os, then whichever optional fields the flags say ---
+bool GzipStream::headerByte(uint8_t c) {
+    switch (state) {
+    case G_HEADER:
+        bytes[have++] = c;
+        if (have < 10) return true;
+        if (bytes[0] != 0x1F || bytes[1] != 0x8B || bytes[2] != 8) return false; // Deflate is the only method
+        flags = bytes[3];
+        if (flags & 0xE0) return false; // Reserved bits
+        state = G_EXTRA_LEN;
+        have = 0;
+        skip = 0;
+        if (!(flags & GZIP_FEXTRA)) afterHeaderField();
+        return true;
+
+    case G_EXTRA_LEN:
+        skip |= (uint32_t)c << (8 * have++);
+        if (have == 2) {
+            state = G_EXTRA;
+            if (skip == 0) afterHeaderField();
+        }
+        return true;
+
+    case G_EXTRA:
+        if (--skip == 0) afterHeaderField();
+        return true;
+
+    case G_NAME:
+    case G_COMMENT:
+        if (c == 0) afterHeaderField();
+        return true;
+
+    case G_HCRC:
+        if (++have == 2) afterHeaderField();
+        return true;
+
+    default:
+        return false;
+    }
+}
+
+// CRC-32 and length, little endian, against what came out
+void GzipStream::checkTrailer() {
+    uint32_t wantCrc = bytes[0] | (bytes[1] << 8) | (bytes[2] << 16) | ((uint32_t)bytes[3] << 24);
+    uint32_t wantLen = bytes[4] | (bytes[5] << 8) | (bytes[6] << 16) | ((uint32_t)bytes[7] << 24);
+    state = (wantCrc == crc && wantLen == bytesOut) ? G_DONE : G_ERROR;
+}
+
+// Move on to the next field the flags ask for, or the compressed data
+void GzipStream::afterHeaderField() {
+    have = 0;
+    if (state < G_NAME && (flags & GZIP_FNAME)) state = G_NAME;
+    else if (state < G_COMMENT && (flags & GZIP_FCOMMENT)) state = G_COMMENT;
+    else if (state < G_HCRC && (flags & GZIP_FHCRC)) state = G_HCRC;
+    else state = G_DEFLATE;
+}
+
+// Inflate as much of in as tinfl will take, passing output on as the window fills. Returns the bytes used.
+int GzipStream::inflate(const uint8_t *in, int len, JsonStream &json) {
+    int used = 0;
+    while (1) {
+        int64_t start = esp_timer_get_time();
+        size_t inSize = len - used;
+        size_t outSize = TINFL_LZ_DICT_SIZE - windowPos;
+        uint8_t *out = &memory->window[windowPos];
+        tinfl_status status = tinfl_decompress(&memory->inflator, &in[used], &inSize, memory->window, out, &outSize,
+                                               TINFL_FLAG_HAS_MORE_INPUT);
+        used += inSize;
+        crc = esp_rom_crc32_le(crc, out, outSize);
+        inflateUs += (uint32_t)(esp_timer_get_time() - start);
+
+        if (outSize > 0) {
+            json.feed((const char *)out, outSize);
+            bytesOut += outSize;
+            windowPos = (windowPos + outSize) & (TINFL_LZ_DICT_SIZE - 1);
+        }
+
+        if (status == TINFL_STATUS_DONE) {
+            // tinfl fills its bit buffer ahead of what it decodes and doesn't hand back what it didn't need,
+            // so the trailer can start in there: whole bytes above the padding bits of the last deflate byte.
+            // The rest of it is what's left of in.
+            const tinfl_decompressor &r = memory->inflator;
+            state = G_TRAILER;
+            have = 0;
+            for (uint32_t bit = r.m_num_bits & 7; bit + 8 <= r.m_num_bits && have < 8; bit += 8) {
+                bytes[have++] = (uint8_t)((uint64_t)r.m_bit_buf >> bit);
+            }
+            if (have == 8) checkTrailer();
+            return used;
+        }
+        if (status < 0) {
+            state = G_ERROR;
+            return len;
+        }
+        if (status == TINFL_STATUS_NEEDS_MORE_INPUT) {
+            return len; // tinfl keeps whatever bits it was part way through
+        }
+        // TINFL_STATUS_HAS_MORE_OUTPUT: the window's been passed on, go round again
+    }
+}
@@ -0,0 +1,58 @@
+#ifndef GZIP_STREAM_H
+#define GZIP_STREAM_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "json_stream.h"
+
+// Inflates a gzip (RFC 1952) body as it arrives and feeds what comes out straight into a JsonStream,
+// using the tinfl decompressor in the S3's ROM. Output goes round tinfl's 32 KB window, and that window
+// is all the inflated body ever takes up.
+//
+// The window and decompressor state (about 43 KB together) are allocated the first time a gzipped
+// response comes in, in PSRAM if there is any, and kept from then on.
+class GzipStream {
+public:
+    void begin();
+
+    // Inflate the next piece into json, false once it's turned out not to be valid gzip
+    bool feed(const char *data, int len, JsonStream &json);
+
+    // End of input. True if the whole member arrived and its CRC and length check out
+    bool finish() const { return state == G_DONE; }
+
+    uint32_t bytesIn = 0;   // Compressed, as received
+    uint32_t bytesOut = 0;  // Inflated, as parsed
+    uint32_t inflateUs = 0; // Time in tinfl and the CRC, not counting the parser
+
+    static size_t memoryBytes();
+
+private:
+    enum State {
+        G_HEADER,    // The fixed 10 bytes
+        G_EXTRA_LEN,
+        G_EXTRA,
+        G_NAME,
+        G_COMMENT,
+        G_HCRC,
+        G_DEFLATE,
+        G_TRAILER,   // CRC-32 and length of the inflated data
+        G_DONE,
+        G_ERROR
+    };
+
+    bool headerByte(uint8_t c);
+    void afterHeaderField();
+    void checkTrailer();
+    int inflate(const uint8_t *in, int len, JsonStream &json);
+
+    State state = G_ERROR;
+    uint8_t flags = 0;
+    uint8_t bytes[10]; // Header, then trailer
+    int have = 0;
+    uint32_t skip = 0;
+    uint32_t crc = 0;
+    size_t windowPos = 0;
+};
+
+#endif // GZIP_STREAM_H
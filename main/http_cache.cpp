@@ -0,0 +1,95 @@
+#include "http_cache.h"
+#include "nvs.h"
+#include <stdio.h>
+#include <string.h>
+#include <strings.h>
+
+#define HTTP_CACHE_NAMESPACE "http_cache"
+
+// FNV-1a, just to notice the URL has changed under a saved entry
+static uint32_t hashUrl(const char *s, uint32_t h = 2166136261u) {
+    while (*s) {
+        h ^= (uint8_t)*s++;
+        h *= 16777619u;
+    }
+    return h;
+}
+
+// The same over the validators too, 0 when there are none to go by
+static uint32_t hashValidators(const HttpValidators &v) {
+    if (!v.etag[0] && !v.lastModified[0]) return 0;
+    uint32_t h = hashUrl(v.lastModified, hashUrl(v.etag, v.urlHash));
+    return h ? h : 1;
+}
+
+void HttpCacheEntry::load() {
+    nvs_handle_t nvs;
+    if (nvs_open(HTTP_CACHE_NAMESPACE, NVS_READONLY, &nvs) != ESP_OK) return;
+
+    HttpValidators v;
+    size_t len = sizeof(v);
+    if (nvs_get_blob(nvs, name, &v, &len) == ESP_OK && len == sizeof(v) && v.urlHash == hashUrl(url)) {
+        saved = v;
+        printf("HTTP CACHE: %s has ETag %s, Last-Modified %s\n", name, saved.etag, saved.lastModified);
+    }
+    nvs_close(nvs);
+}
+
+uint32_t HttpCacheEntry::validatorsHash() const {
+    return haveData ? hashValidators(saved) : 0;
+}
+
+void HttpCacheEntry::restored(uint32_t hash) {
+    haveData = hash != 0 && hash == hashValidators(saved);
+    if (!haveData) printf("HTTP CACHE: %s restored data isn't what the saved validators describe, fetching it again\n", name);
+}
+
+void HttpCacheEntry::begin(esp_http_client_handle_t client) {
+    received = {};
+    requests++;
+
+    // The client may be shared with other URLs, so clear out whatever their requests left set
+    if (haveData && saved.etag[0]) esp_http_client_set_header(client, "If-None-Match", saved.etag);
+    else esp_http_client_delete_header(client, "If-None-Match");
+
+    if (haveData && saved.lastModified[0]) esp_http_client_set_header(client, "If-Modified-Since", saved.lastModified);
+    else esp_http_client_delete_header(client, "If-Modified-Since");
+}
+
+void HttpCacheEntry::onHeader(const char *key, const char *value) {
+    if (strcasecmp(key, "ETag") == 0 && strlen(value) < HTTP_CACHE_ETAG_MAX) {
+        strcpy(received.etag, value);
+    } else if (strcasecmp(key, "Last-Modified") == 0 && strlen(value) < HTTP_CACHE_DATE_MAX) {
+        strcpy(received.lastModified, value);
+    }
+}
+
+void HttpCacheEntry::used(uint32_t bodyBytes, uint32_t parseUs) {
+    received.urlHash = hashUrl(url);
+    received.bodyBytes = bodyBytes;
+    received.parseUs = parseUs;
+    haveData = true;
+
+    // Flash only gets written when the validators actually move on
+    bool changed = strcmp(received.etag, saved.etag) != 0 || strcmp(received.lastModified, saved.lastModified) != 0 ||
+                   received.urlHash != saved.urlHash;
+    saved = received;
+    if (!changed) return;
+
+    nvs_handle_t nvs;
+    if (nvs_open(HTTP_CACHE_NAMESPACE, NVS_READWRITE, &nvs) != ESP_OK) return;
+    if (nvs_set_blob(nvs, name, &saved, sizeof(saved)) == ESP_OK) nvs_commit(nvs);
+    nvs_close(nvs);
+}
+
+void HttpCacheEntry::notModified() {
+    notModifiedCount++;
+    bytesSaved += saved.bodyBytes;
+    parseUsSaved += saved.parseUs;
+}
+
+void HttpCacheEntry::report() const {
+    printf("HTTP CACHE: %s %lu/%lu not modified, saved %llu bytes and %llu us of parsing\n", name,
+           (unsigned long)notModifiedCount, (unsigned long)requests,
+           (unsigned long long)bytesSaved, (unsigned long long)parseUsSaved);
+}
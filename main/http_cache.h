@@ -0,0 +1,62 @@
+#ifndef HTTP_CACHE_H
+#define HTTP_CACHE_H
+
+#include <stdint.h>
+#include "esp_http_client.h"
+
+#define HTTP_CACHE_ETAG_MAX 64 // Longer ETags just aren't cached
+#define HTTP_CACHE_DATE_MAX 32
+
+// What the server said about the last response we used in full. Sent back on the next request so it
+// can answer 304 Not Modified instead of the whole thing again. Kept in NVS, so it survives a reboot.
+struct HttpValidators {
+    uint32_t urlHash;   // Which URL these are for
+    uint32_t bodyBytes; // Size of that response
+    uint32_t parseUs;   // How long parsing it took
+    char etag[HTTP_CACHE_ETAG_MAX];
+    char lastModified[HTTP_CACHE_DATE_MAX];
+};
+
+// Conditional GETs for one URL, plus counters of what they've saved
+class HttpCacheEntry {
+public:
+    // name is the NVS key, so 15 characters at most
+    HttpCacheEntry(const char *name, const char *url) : name(name), url(url) {}
+
+    // Pick up the validators from before the reboot, if they're for this URL
+    void load();
+
+    // Set once whatever the validators describe is held again (parsed this boot, or restored). Until
+    // then a 304 would leave us with nothing, so requests aren't made conditional.
+    bool haveData = false;
+
+    // Identifies the response the data held was made from: its URL and validators, 0 without haveData or if
+    // the server sent no validators. Saved along with a copy of that data (the snapshot).
+    uint32_t validatorsHash() const;
+
+    // That copy is back after a reboot: haveData if the validators load() picked up are still the ones it
+    // was saved with, rather than ones from a response it never saw
+    void restored(uint32_t hash);
+
+    // --- Per request ---
+    void begin(esp_http_client_handle_t client);        // Adds If-None-Match / If-Modified-Since
+    void onHeader(const char *key, const char *value); // From HTTP_EVENT_ON_HEADER
+    void used(uint32_t bodyBytes, uint32_t parseUs);    // 200 parsed and applied, keep its validators
+    void notModified();                                 // 304
+
+    void report() const;
+
+    const char *const name;
+    const char *const url;
+
+private:
+    HttpValidators saved = {};
+    HttpValidators received = {};
+
+    uint32_t requests = 0;
+    uint32_t notModifiedCount = 0;
+    uint64_t bytesSaved = 0;
+    uint64_t parseUsSaved = 0;
+};
+
+#endif // HTTP_CACHE_H
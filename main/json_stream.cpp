@@ -0,0 +1,227 @@
+#include "json_stream.h"
+#include <string.h>
+
+static bool isSpace(char c) { return c == ' ' || c == '\t' || c == '\n' || c == '\r'; }
+
+static bool isBare(char c) {
+    return (c >= '0' && c <= '9') || (c >= 'a' && c <= 'z') || c == '-' || c == '+' || c == '.' || c == 'E';
+}
+
+static int hexValue(char c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return -1;
+}
+
+void JsonStream::reset() {
+    level = 0;
+    state = S_VALUE;
+    tokenLen = 0;
+    fed = 0;
+}
+
+bool JsonStream::feed(const char *data, int len) {
+    fed += len;
+    for (int i = 0; i < len && state != S_ERROR; ) {
+        if (step(data[i])) i++;
+    }
+    return state != S_ERROR;
+}
+
+bool JsonStream::finish() {
+    if (state == S_BARE) endBare(); // A document that's just a number or literal
+    return state == S_DONE;
+}
+
+void JsonStream::emit(JsonEvent event, const char *value) {
+    listener->onJson(*this, event, value);
+}
+
+bool JsonStream::open(bool object) {
+    if (level == JSON_MAX_DEPTH) return false;
+    emit(object ? JSON_OBJECT_START : JSON_ARRAY_START, NULL);
+
+    Level &l = stack[level++];
+    l.object = object;
+    l.empty = true;
+    l.index = 0;
+    l.key[0] = 0;
+    state = object ? S_KEY : S_VALUE;
+    return true;
+}
+
+bool JsonStream::close(bool object) {
+    if (level == 0 || stack[level - 1].object != object) return false;
+    level--;
+    emit(object ? JSON_OBJECT_END : JSON_ARRAY_END, NULL);
+    afterValue();
+    return true;
+}
+
+void JsonStream::afterValue() {
+    if (level > 0) stack[level - 1].empty = false;
+    state = (level == 0) ? S_DONE : S_AFTER_VALUE;
+}
+
+void JsonStream::append(char c) {
+    if (tokenLen < JSON_MAX_TOKEN - 1) token[tokenLen++] = c; // Too long just gets cut short
+}
+
+void JsonStream::appendUtf8(uint16_t code) {
+    if (code < 0x80) {
+        append((char)code);
+    } else if (code < 0x800) {
+        append((char)(0xC0 | (code >> 6)));
+        append((char)(0x80 | (code & 0x3F)));
+    } else if (code >= 0xD800 && code <= 0xDFFF) {
+        append('?'); // Half a surrogate pair, nothing we show needs them
+    } else {
+        append((char)(0xE0 | (code >> 12)));
+        append((char)(0x80 | ((code >> 6) & 0x3F)));
+        append((char)(0x80 | (code & 0x3F)));
+    }
+}
+
+void JsonStream::endBare() {
+    token[tokenLen] = 0;
+    if (strcmp(token, "true") == 0 || strcmp(token, "false") == 0) {
+        emit(JSON_BOOL, token);
+    } else if (strcmp(token, "null") == 0) {
+        emit(JSON_NULL, token);
+    } else if (token[0] == '-' || (token[0] >= '0' && token[0] <= '9')) {
+        emit(JSON_NUMBER, token);
+    } else {
+        state = S_ERROR;
+        return;
+    }
+    afterValue();
+}
+
+// One character, false if it has to be looked at again in the new state
+bool JsonStream::step(char c) {
+    switch (state) {
+    case S_VALUE:
+        if (isSpace(c)) return true;
+        if (c == '{') { if (!open(true)) state = S_ERROR; return true; }
+        if (c == '[') { if (!open(false)) state = S_ERROR; return true; }
+        if (c == ']' && level > 0 && stack[level - 1].empty) { close(false); return true; }
+        if (c == '"') {
+            stringIsKey = false;
+            tokenLen = 0;
+            state = S_STRING;
+            return true;
+        }
+        if (c == '-' || (c >= '0' && c <= '9') || c == 't' || c == 'f' || c == 'n') {
+            tokenLen = 0;
+            append(c);
+            state = S_BARE;
+            return true;
+        }
+        state = S_ERROR;
+        return true;
+
+    case S_KEY:
+        if (isSpace(c)) return true;
+        if (c == '"') {
+            stringIsKey = true;
+            tokenLen = 0;
+            state = S_STRING;
+        } else if (c == '}' && stack[level - 1].empty) {
+            close(true);
+        } else {
+            state = S_ERROR;
+        }
+        return true;
+
+    case S_COLON:
+        if (isSpace(c)) return true;
+        state = (c == ':') ? S_VALUE : S_ERROR;
+        return true;
+
+    case S_AFTER_VALUE: {
+        if (isSpace(c)) return true;
+        Level &l = stack[level - 1];
+        if (c == ',') {
+            if (l.object) {
+                state = S_KEY;
+            } else {
+                l.index++;
+                state = S_VALUE;
+            }
+        } else if (!(c == '}' && close(true)) && !(c == ']' && close(false))) {
+            state = S_ERROR;
+        }
+        return true;
+    }
+
+    case S_STRING:
+        if (c == '\\') {
+            state = S_ESCAPE;
+        } else if (c == '"') {
+            token[tokenLen] = 0;
+            if (stringIsKey) {
+                Level &l = stack[level - 1];
+                int n = (tokenLen < JSON_MAX_KEY - 1) ? tokenLen : JSON_MAX_KEY - 1;
+                memcpy(l.key, token, n);
+                l.key[n] = 0;
+                state = S_COLON;
+            } else {
+                emit(JSON_STRING, token);
+                afterValue();
+            }
+        } else {
+            append(c);
+        }
+        return true;
+
+    case S_ESCAPE:
+        state = S_STRING;
+        switch (c) {
+        case '"': case '\\': case '/': append(c); break;
+        case 'b': append('\b'); break;
+        case 'f': append('\f'); break;
+        case 'n': append('\n'); break;
+        case 'r': append('\r'); break;
+        case 't': append('\t'); break;
+        case 'u':
+            unicode = 0;
+            unicodeDigits = 0;
+            state = S_UNICODE;
+            break;
+        default:
+            state = S_ERROR;
+        }
+        return true;
+
+    case S_UNICODE: {
+        int v = hexValue(c);
+        if (v < 0) {
+            state = S_ERROR;
+            return true;
+        }
+        unicode = (unicode << 4) | v;
+        if (++unicodeDigits == 4) {
+            appendUtf8(unicode);
+            state = S_STRING;
+        }
+        return true;
+    }
+
+    case S_BARE:
+        if (isBare(c)) {
+            append(c);
+            return true;
+        }
+        endBare();
+        return false; // Whatever ended it belongs to the container
+
+    case S_DONE:
+        if (!isSpace(c)) state = S_ERROR;
+        return true;
+
+    case S_ERROR:
+        return true;
+    }
+    return true;
+}
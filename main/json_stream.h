@@ -0,0 +1,106 @@
+#ifndef JSON_STREAM_H
+#define JSON_STREAM_H
+
+#include <stdint.h>
+
+#define JSON_MAX_DEPTH 16 // Nested objects / arrays
+#define JSON_MAX_KEY 24   // Longest member name kept, longer ones are cut short
+#define JSON_MAX_TOKEN 64 // Longest string or number kept, likewise
+
+enum JsonEvent {
+    JSON_OBJECT_START,
+    JSON_OBJECT_END,
+    JSON_ARRAY_START,
+    JSON_ARRAY_END,
+    JSON_STRING,
+    JSON_NUMBER,
+    JSON_BOOL,
+    JSON_NULL
+};
+
+class JsonStream;
+
+// Told about every value as the parser gets to it
+class JsonListener {
+public:
+    virtual ~JsonListener() {}
+
+    // value is the text of strings, numbers, booleans ("true" / "false") and null, NULL for the
+    // start and end of objects and arrays
+    virtual void onJson(const JsonStream &json, JsonEvent event, const char *value) = 0;
+};
+
+// Incremental (SAX style) JSON parser. Feed it the document in pieces of any size, straight from
+// the network, and the listener hears about each value as it's completed. Nothing is kept apart from
+// the path to the current value, so memory use is fixed however big the document is.
+//
+// Where a value sits is given by its depth (0 for the document itself, 1 for the members of the
+// outermost object or array, ...) and, for each level down to it, the member name or array index.
+class JsonStream {
+public:
+    explicit JsonStream(JsonListener *listener) : listener(listener) {}
+
+    void reset();
+
+    // Parse the next piece of the document, false once it's turned out not to be valid JSON
+    bool feed(const char *data, int len);
+
+    // End of input. True if it was exactly one complete document
+    bool finish();
+
+    bool failed() const { return state == S_ERROR; }
+    uint32_t bytesFed() const { return fed; }
+
+    // --- Position of the current value, for listeners ---
+    int depth() const { return level; }
+
+    // Member name at a level (1..depth), "" inside arrays
+    const char *key(int at) const { return stack[at - 1].key; }
+    const char *key() const { return level ? key(level) : ""; }
+
+    // Array index at a level (1..depth)
+    int index(int at) const { return stack[at - 1].index; }
+
+private:
+    enum State {
+        S_VALUE,       // Expecting a value
+        S_AFTER_VALUE, // Expecting , or the end of the container
+        S_KEY,         // Expecting a member name
+        S_COLON,
+        S_STRING,
+        S_ESCAPE,
+        S_UNICODE,
+        S_BARE,        // Number, true, false or null
+        S_DONE,
+        S_ERROR
+    };
+
+    struct Level {
+        bool object;
+        bool empty; // Nothing in it yet, so it can be closed straight away
+        int index;
+        char key[JSON_MAX_KEY];
+    };
+
+    void emit(JsonEvent event, const char *value);
+    bool open(bool object);
+    bool close(bool object);
+    void afterValue();
+    void append(char c);
+    void appendUtf8(uint16_t code);
+    void endBare();
+    bool step(char c);
+
+    JsonListener *listener;
+    Level stack[JSON_MAX_DEPTH];
+    int level = 0;
+    State state = S_VALUE;
+    bool stringIsKey = false;
+    char token[JSON_MAX_TOKEN];
+    int tokenLen = 0;
+    uint16_t unicode = 0;
+    int unicodeDigits = 0;
+    uint32_t fed = 0;
+};
+
+#endif // JSON_STREAM_H
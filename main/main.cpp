@@ -25,30 +25,20 @@
 #include "pacman_engine.h"
 #include "tba_network.h"
 #include "matrix_display.h"
+#include "boot_log.h"
 
 // --- Global Variable Definitions ---
-std::vector<std::string> tickerQueue;
-
 MatrixPanel_I2S_DMA *matrix = nullptr;
 GFXcanvas16 *canvas_dev = new GFXcanvas16(256, 64);
 
-GameScore matchHistory[12];
-int matchesCompleted = 0;
-
-MatchEntry schedule[3] = {
-    {'Q', 42, 0xF800, 0}, // Next
-    {'Q', 51, 0x001F, 0}, // Following
-    {'Q', 68, 0xF800, 0}  // Final scheduled
-};
-
-int currentlyPlaying = 39;
+DisplayModelStore displayModel;
 
 LastMatchData lastMatch = {38, 124, 110, true, 3}; // Initialized with mock data
 
 // Pac-Man Game State
-float pacPos = 0;
-float ghostPos[4] = {-20, -40, -60, -80};
-float worldSpeed = 1.2f;
+Motion pacPos;
+Motion ghostPos[4] = {Motion(ANIM_FIX(-20)), Motion(ANIM_FIX(-40)), Motion(ANIM_FIX(-60)), Motion(ANIM_FIX(-80))};
+int32_t worldSpeed = PAC_SPEED;
 bool powerMode = false;
 uint32_t powerStartTime = 0;
 bool borderActive = false;
@@ -56,10 +46,22 @@ uint32_t lastBorderStartTime = 0;
 GhostState ghostState[4] = {GHOST_ALIVE, GHOST_ALIVE, GHOST_ALIVE, GHOST_ALIVE};
 uint32_t winStartTime = 0;
 
-// Event Schedule
-std::string nextEventName = "";
-time_t nextEventDate = 0;
 
+static void on_got_ip(void *arg, esp_event_base_t base, int32_t id, void *data) {
+    boot_mark(BOOT_IP);
+}
+
+static void on_time_sync(struct timeval *tv) {
+    boot_mark(BOOT_TIME_SYNCED);
+}
+
+// THE AP RESET (GPIO 7 - Down Button)
+// Set up before anything else runs: matrix_task watches it, and holding it wipes the WiFi credentials
+void setup_button() {
+    gpio_reset_pin(GPIO_NUM_7);
+    gpio_set_direction(GPIO_NUM_7, GPIO_MODE_INPUT);
+    gpio_set_pull_mode(GPIO_NUM_7, GPIO_PULLUP_ONLY);
+}
 
 void setup_networking() {
     // 1. Initialize NVS (Required for WiFi storage)
@@ -70,22 +72,17 @@ void setup_networking() {
     }
     ESP_ERROR_CHECK(ret);
 
-    // 2. THE AP RESET (GPIO 7 - Down Button)
-    // We do this BEFORE starting WiFi so we can wipe the slate clean
-    gpio_reset_pin(GPIO_NUM_7);
-    gpio_set_direction(GPIO_NUM_7, GPIO_MODE_INPUT);
-    gpio_set_pull_mode(GPIO_NUM_7, GPIO_PULLUP_ONLY);
-    
-    // 3. Init Network Stack
+    // 2. Init Network Stack
     ESP_ERROR_CHECK(esp_netif_init());
     ESP_ERROR_CHECK(esp_event_loop_create_default());
+    esp_event_handler_register(IP_EVENT, IP_EVENT_STA_GOT_IP, on_got_ip, NULL);
     esp_netif_create_default_wifi_sta();
     esp_netif_create_default_wifi_ap();
 
     wifi_init_config_t cfg = WIFI_INIT_CONFIG_DEFAULT();
     ESP_ERROR_CHECK(esp_wifi_init(&cfg));
 
-    // 4. Define Hardcoded Credentials
+    // 3. Define Hardcoded Credentials
     wifi_config_t static_wifi_config = {};
     strcpy((char*)static_wifi_config.sta.ssid, WIFI_SSID);
     strcpy((char*)static_wifi_config.sta.password, WIFI_PASS);
@@ -93,7 +90,7 @@ void setup_networking() {
     const char *service_name = PROV_SERVICE_NAME;
     const char *pop = PROV_POP; // Proof of Possession
 
-    // 5. Setup Provisioning Manager
+    // 4. Setup Provisioning Manager
     wifi_prov_mgr_config_t config = {};
     config.scheme = wifi_prov_scheme_ble;
     ESP_ERROR_CHECK(wifi_prov_mgr_init(config));
@@ -135,13 +132,25 @@ void setup_networking() {
         esp_wifi_connect();
     }
 
-    // 6. Time Sync
+    // 5. Time Sync
     esp_sntp_config_t sntp_cfg = ESP_NETIF_SNTP_DEFAULT_CONFIG("pool.ntp.org");
+    sntp_cfg.sync_cb = on_time_sync;
     esp_netif_sntp_init(&sntp_cfg);
     setenv("TZ", "EST5EDT,M3.2.0,M11.1.0", 1);
     tzset();
 }
 
+// WiFi (waiting on the hardcoded network, maybe BLE provisioning after) and SNTP take anything up to
+// tens of seconds, so they come up here while the display is already running
+static void network_task(void *pvParameters) {
+    // Real data from before the reboot, if there is any, over the mock data. Mounting the snapshot's
+    // partition (formatting it, first boot) happens here so it doesn't hold up the panel.
+    tba_restore_snapshot();
+    setup_networking();
+    xTaskCreatePinnedToCore(tba_api_task, "tba_api_task", 10240, NULL, 5, NULL, 1);
+    vTaskDelete(NULL);
+}
+
 extern "C" void app_main(void) {
     HUB75_I2S_CFG mxconfig(64, 64, 4);
     mxconfig.gpio.r1 = 42; mxconfig.gpio.g1 = 41; mxconfig.gpio.b1 = 40;
@@ -152,13 +161,24 @@ extern "C" void app_main(void) {
     mxconfig.clkphase = false;
     mxconfig.latch_blanking = 4;
     mxconfig.i2sspeed = HUB75_I2S_CFG::HZ_8M;
+    mxconfig.modulation = HUB75_I2S_CFG::BCM_OE_WEIGHTED;
+    mxconfig.row_scan_order = HUB75_I2S_CFG::SCAN_SCRAMBLED;
+    mxconfig.source = HUB75_I2S_CFG::SOURCE_RGB565;
+    // Mock data to show until TBA's (or the snapshot's) replaces it
+    DisplayModel &model = displayModel.edit();
+    model.schedule[0] = {'Q', 42, 0xF800, 0}; // Next
+    model.schedule[1] = {'Q', 51, 0x001F, 0}; // Following
+    model.schedule[2] = {'Q', 68, 0xF800, 0}; // Final scheduled
+    model.currentlyPlaying = 39;
     addMatchResult(12, 15, 15, 45, 30, 5, 156, true, true);  // Great game
     addMatchResult(24, 8, 0, 32, 20, 15, 98, false, false); // Rough game
     matrix = new MatrixPanel_I2S_DMA(mxconfig);
     if (matrix->begin()) {
         matrix->setBrightness8(60);
-        setup_networking();
+        setup_button();
+        // Display first: the boot zoom, then the dashboard from the snapshot, while it's restored and the
+        // network comes up
         xTaskCreatePinnedToCore(matrix_task, "matrix_task", 8192, NULL, 10, NULL, 1);
-        xTaskCreatePinnedToCore(tba_api_task, "tba_api_task", 10240, NULL, 5, NULL, 1);
+        xTaskCreatePinnedToCore(network_task, "network_task", 6144, NULL, 5, NULL, 0);
     }
 }
@@ -11,11 +11,22 @@
 #include "esp_timer.h"
 #include "esp_wifi.h"
 #include "nvs_flash.h"
-#include "wifi_provisioning/manager.h"
+#include "boot_log.h"
 #include "esp_system.h"
+#include "esp_attr.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
 #include <time.h>
-#include <math.h>
+#include <sys/time.h>
+#include <string.h>
+#include <limits.h>
 #include "sponsors.h"
+#include "display_layers.h"
+#include "display_list.h"
+#include "scene_manager.h"
+#include "ticker_store.h"
+#include "animation.h"
+#include "fast_math.h"
 
 enum SponsorState {
     SPONSOR_IDLE,
@@ -24,39 +35,263 @@ enum SponsorState {
     SPONSOR_OUTRO
 };
 
+// This frame's snapshot of the TBA data, taken once at the top of each frame
+static const DisplayModel *model = nullptr;
+
+// --- Frame Timing ---
+// matrix_task sleeps until the next thing on screen changes, but never draws faster than FRAME_MS
+// and never sleeps longer than MAX_SLEEP_MS, so anything no scene predicts still gets looked at.
+#define FRAME_MS 25
+#define MAX_SLEEP_MS 1000
+#define DUTY_REPORT_MS 10000
+
+static TaskHandle_t volatile matrixTask = nullptr;
+
+void matrix_wake() {
+    if (matrixTask) xTaskNotifyGive(matrixTask);
+}
+
+static void IRAM_ATTR button_isr(void *arg) {
+    BaseType_t woken = pdFALSE;
+    if (matrixTask) vTaskNotifyGiveFromISR(matrixTask, &woken);
+    portYIELD_FROM_ISR(woken);
+}
+
+// --- Border Pulses ---
+// Run off the clock rather than the frame count, so their speed doesn't depend on how often frames
+// come, and the next step that actually changes the 565 colour can be found ahead of time.
+//
+// They only step every PULSE_FRAME_MS. Where a pulse is all that's moving (the sponsor waits, which redraw
+// the whole screen for it) that's 25 frames a second rather than 40, and on the dashboard the border is
+// recomposited on fewer of the ticker's frames.
+#define ORANGE_PULSE_MS 1570 // 0.1 rad every 25ms frame, as before
+#define GREEN_PULSE_MS 524   // 0.3 rad a frame
+#define PULSE_FRAME_MS 40
+
+static uint8_t pulseLevel(uint32_t ms, uint32_t periodMs) {
+    return beatsin8(ms - ms % PULSE_FRAME_MS, periodMs, 50, 250);
+}
+
+static uint16_t orangePulse(uint32_t ms) {
+    uint8_t p = pulseLevel(ms, ORANGE_PULSE_MS);
+    return matrix->color565(p, (p * 140 / 255), 0);
+}
+
+static uint16_t greenPulse(uint32_t ms) {
+    return matrix->color565(0, pulseLevel(ms, GREEN_PULSE_MS), 0);
+}
+
+// How long until colorAt() comes out different from now, MAX_SLEEP_MS at most
+static uint32_t msUntilPulseChange(uint32_t nowMs, uint16_t (*colorAt)(uint32_t)) {
+    uint16_t color = colorAt(nowMs);
+    for (uint32_t ms = PULSE_FRAME_MS - nowMs % PULSE_FRAME_MS; ms < MAX_SLEEP_MS; ms += PULSE_FRAME_MS) {
+        if (colorAt(nowMs + ms) != color) return ms;
+    }
+    return MAX_SLEEP_MS;
+}
+
 bool isSafeForSponsors() {
     time_t now;
     time(&now);
 
     // Check against schedule
     for (int i = 0; i < 3; i++) {
-        if (schedule[i].estTime != 0) {
-            double diff = difftime(schedule[i].estTime, now);
+        if (model->schedule[i].estTime != 0) {
+            time_t diff = model->schedule[i].estTime - now;
             // "within 30 min of a match" -> -30min to +30min (approx)
             // If match is 10 mins ago, diff is -600.
             // If match is 10 mins in future, diff is 600.
-            if (fabs(diff) < 30 * 60) return false;
+            if (diff > -30 * 60 && diff < 30 * 60) return false;
         }
     }
     return true;
 }
 
 void drawTiger(GFXcanvas16 *canvas, int x, int y) {
+    // Straight into the buffer a row at a time, clipped to the canvas
+    uint16_t *buf = canvas->getBuffer();
+    int w = canvas->width();
+    int h = canvas->height();
+    int colStart = (x < 0) ? -x : 0;
+    int colEnd = (x + 64 > w) ? w - x : 64;
+    if (colEnd <= colStart) return;
+
     for (int row = 0; row < 64; row++) {
-        for (int col = 0; col < 64; col++) {
-            uint16_t color = tiger_hires_map[row * 64 + col];
-            canvas->drawPixel(x + col, y + row, color);
+        int py = y + row;
+        if (py < 0 || py >= h) continue;
+        memcpy(&buf[py * w + x + colStart], &tiger_hires_map[row * 64 + colStart], (colEnd - colStart) * sizeof(uint16_t));
+    }
+}
+
+// --- Display Layers ---
+// Bottom to top: the background (dashboard statics, or whatever full screen is up instead of the dashboard),
+// ticker and side panel, clock and status, sponsor header, then the border / Pac-Man. Black is see-through
+// on everything drawn over the background except the border, which keys on BORDER_KEY so the win pulse
+// can still blank the edges.
+#define BORDER_KEY 0x0001
+#define BORDER_BAND 7 // Pac-Man and the ghosts stay within this many pixels of the edge
+
+static DisplayLayer *bgLayer = nullptr;
+static DisplayLayer *tickerLayer = nullptr;
+static DisplayLayer *panelLayer = nullptr;
+static DisplayLayer *clockLayer = nullptr;
+static DisplayLayer *statusLayer = nullptr;
+static DisplayLayer *headerLayer = nullptr;
+static DisplayLayer *borderLayer = nullptr;
+
+// Background is only redrawn when the view it was drawn for changes
+static bool bgValid = false;
+static bool bgUpcoming = false;
+static bool bgHasStats = false;
+
+static void renderBackground(bool upcoming, bool hasStats, uint16_t tigerOrange) {
+    GFXcanvas16 *bg = bgLayer->canvas;
+    bg->fillScreen(0);
+
+    drawTiger(bg, -5, -3);
+
+    bg->setFont(&FreeSansBold18pt7b);
+    bg->setTextColor(tigerOrange);
+    bg->setCursor(52, 40);
+    bg->print("5459");
+
+    bg->drawFastVLine(130, 5, 54, 0x3186);
+
+    bg->setFont(NULL);
+    if (upcoming) {
+        bg->drawFastHLine(135, 14, 115, 0x3186); // Header separator
+        bg->setTextColor(0x7BEF); // Gray
+        bg->setCursor(138, 18);
+        bg->print("UPCOMING");
+    } else if (hasStats) {
+        bg->drawFastHLine(135, 14, 115, 0x3186);
+    }
+
+    // RANK INFO (Panel 4)
+    bg->setTextColor(0x7BEF);
+    bg->setCursor(220, 18);
+    bg->print("RANK");
+
+    bg->setFont(&FreeSansBold12pt7b);
+    bg->setTextColor(0xFFE0); // Yellow
+    bg->setCursor(215, 45);
+    bg->print("12");
+
+    bgLayer->markDirty();
+    bgUpcoming = upcoming;
+    bgHasStats = hasStats;
+    bgValid = true;
+}
+
+// Something other than the dashboard is going on the background
+static GFXcanvas16 *takeBackground() {
+    bgLayer->canvas->fillScreen(0);
+    bgLayer->markDirty();
+    bgValid = false;
+    return bgLayer->canvas;
+}
+
+static void recordSidePanel(DisplayList &list, bool upcoming) {
+    uint16_t white = 0xFFFF;
+
+    list.setFont(NULL); // Small fixed font
+    if (upcoming) {
+        // 1. HEADER: Currently Playing
+        list.setTextColor(0xFFE0); // Yellow
+        list.setCursor(138, 5);
+        list.print("NOW ON FIELD: Q");
+        list.print(model->currentlyPlaying);
+
+        // 2. COLOR-CODED MATCH LIST
+        for (int i = 0; i < 3; i++) {
+            int yOff = 29 + (i * 10); // 10 pixels spacing for better legibility
+
+            // Match Type and Number (Color-coded by Alliance)
+            list.setTextColor(model->schedule[i].color);
+            list.setCursor(138, yOff);
+
+            // Example: "Q42"
+            list.print(model->schedule[i].type);
+            list.print(model->schedule[i].number);
+
+            // Optional: Draw a small dot or dash in the alliance color to the left
+            // to make it "pop" even more
+            list.drawFastVLine(134, yOff - 1, 7, model->schedule[i].color);
+
+            // Est Time (Placeholder - assuming you add 'est_time' to your struct later)
+            list.setTextColor(white);
+            list.setCursor(160, yOff);
+            list.print("-10:45A");
+        }
+    } else {
+        // --- LAST MATCH STATS VIEW ---
+        if (model->matchesCompleted == 0) {
+            list.setTextColor(white);
+            list.setCursor(145, 30);
+            list.print("AWAITING DATA...");
+        } else {
+            const GameScore &last = model->matchHistory[model->matchesCompleted - 1];
+            list.setTextColor(0x07FF); // Cyan
+            list.setCursor(138, 5);
+            list.print("LAST MATCH: "); list.print(last.type == 'P' ? 'P' : 'Q'); list.print(last.matchNum);
+
+            list.setCursor(138, 18);
+            list.setTextColor(0xF81F); list.print("AUTO:");
+            list.setTextColor(white); list.print(" F"); list.print(last.autoFuel);
+            list.print(" C"); list.print(last.autoClimb);
+
+            list.setCursor(138, 27);
+            list.setTextColor(0x07E0); list.print("TELE:");
+            list.setTextColor(white); list.print(" F"); list.print(last.teleFuel);
+            if (last.fuelRP) { list.setTextColor(0xFBE0); list.print("**"); }
+
+            list.setCursor(138, 36);
+            list.setTextColor(white); list.print("CLIMB:");
+            list.print(last.teleClimb/10);
+            if (last.towerRP) { list.setTextColor(0x07FF); list.print("*"); }
+
+            list.setCursor(138, 45);
+            list.setTextColor(0xF800); list.print("FOUL: ");
+            list.setTextColor(white); list.print(last.foulPointsAwarded);
+
+            list.setCursor(138, 54);
+            list.setTextColor(0xFFE0); list.print("SCORE: ");
+            list.print(last.totalScore);
         }
     }
 }
 
-void refreshTickerQueue() {
-    tickerQueue.clear();
+static void drawSponsorHeader(GFXcanvas16 *canvas) {
+    canvas->setFont(NULL);
+    canvas->setTextColor(0xFFFF);
+
+    const char* header = SPONSOR_HEADER_TEXT;
+    // getTextBounds with NULL font works differently or not at all in some GFX versions,
+    // but default font is 6x8 pixels.
+    // Centering manually assuming 6px width per char
+    int len = strlen(header);
+    int w_guess = len * 6;
+    int startX = (256 - w_guess) / 2;
+    if (startX < 0) startX = 0;
+
+    canvas->setCursor(startX, 5);
+    canvas->print(header);
+}
 
-    // Message 1: Team Identity
-    tickerQueue.push_back(MSG_TEAM_NAME);
+static void markBorderDirty() {
+    borderLayer->markDirty(0, 0, 256, BORDER_BAND);
+    borderLayer->markDirty(0, 64 - BORDER_BAND, 256, BORDER_BAND);
+    borderLayer->markDirty(0, BORDER_BAND, BORDER_BAND, 64 - 2 * BORDER_BAND);
+    borderLayer->markDirty(256 - BORDER_BAND, BORDER_BAND, BORDER_BAND, 64 - 2 * BORDER_BAND);
+}
+
+// Ticker messages, laid out in a fixed arena so scrolling never touches the heap
+static TickerStore ticker(&FreeSans9pt7b);
 
+// Rebuild the ticker messages, unless they'd come out the same as they are
+void refreshTicker() {
     // Message 2: Dynamic Countdown
+    char countdown[64];
     time_t now;
     struct tm timeinfo;
     time(&now);
@@ -64,487 +299,706 @@ void refreshTickerQueue() {
 
     // If year > 2020, we know NTP has synced
     if (timeinfo.tm_year > 120) {
-        if (nextEventDate > 0) {
-            double diff = difftime(nextEventDate, now);
-            int days = (int)(diff / 86400);
+        if (model->nextEventDate > 0) {
+            int days = (int)((model->nextEventDate - now) / 86400);
 
             if (days > 0) {
-                tickerQueue.push_back("T-" + std::to_string(days) + " DAYS UNTIL " + nextEventName + " COMP");
-            } else if (days == 0) {
-                tickerQueue.push_back("IT IS TIME FOR " + nextEventName + " COMP!");
+                snprintf(countdown, sizeof(countdown), "T-%d DAYS UNTIL %s COMP", days, model->nextEventName);
+            } else if (days == 0 || now < model->nextEventEnd + 86400) { // Or any day of it
+                snprintf(countdown, sizeof(countdown), "IT IS TIME FOR %s COMP!", model->nextEventName);
             } else {
-                tickerQueue.push_back(MSG_SEASON_START);
+                snprintf(countdown, sizeof(countdown), "%s", MSG_SEASON_START);
             }
         } else {
             // Fallback if no event found yet
-            tickerQueue.push_back("CHECKING SCHEDULE...");
+            snprintf(countdown, sizeof(countdown), "CHECKING SCHEDULE...");
         }
     } else {
-        tickerQueue.push_back(MSG_WAIT_SYNC);
+        snprintf(countdown, sizeof(countdown), "%s", MSG_WAIT_SYNC);
     }
 
-    // Message 3: Fun/Static Info
-    tickerQueue.push_back(MSG_SUBTITLE);
+    if (ticker.size() == 3 && strcmp(ticker[1].text, countdown) == 0) return;
+
+    ticker.clear();
+    ticker.add("%s", MSG_TEAM_NAME);  // Message 1: Team Identity
+    ticker.add("%s", countdown);
+    ticker.add("%s", MSG_SUBTITLE);   // Message 3: Fun/Static Info
 }
 
 void addMatchResult(int mNum, int aF, int aC, int tF, int tC, int fouls, int total, bool fRP, bool tRP) {
-    if (matchesCompleted < 12) {
-        matchHistory[matchesCompleted] = {mNum, aF, aC, tF, tC, fouls, total, fRP, tRP};
-        matchesCompleted++;
+    DisplayModel &m = displayModel.edit();
+    if (m.matchesCompleted < 12) {
+        m.matchHistory[m.matchesCompleted] = {mNum, aF, aC, tF, tC, fouls, total, fRP, tRP, 'Q'};
+        m.matchesCompleted++;
+        displayModel.publish();
+        matrix_wake();
     }
 }
 
-void matrix_task(void *pvParameters) {
-    // 1. Initialize Ticker & Colors
-    refreshTickerQueue();
-    uint16_t tigerOrange = matrix->color565(255, 140, 0);
-    uint16_t white = 0xFFFF;
-
-    // Animation & Reset Variables
-    float pulseIdx = 0;
-    bool showZoom = true;
-    float zoom = 0.5f;
-    static uint32_t buttonHoldStart = 0;
-    bool isResetting = false;
+// --- Scenes ---
+// Render budgets are per frame, out of the 25ms between frames
 
-    // Robust Ticker Variables
-    static int currentMsgIdx = 0;
-    static int nextMsgIdx = 1;
-    static float scrollX = 128.0f;
-    const int GAP = 60;
+static uint32_t buttonHoldStart = 0;
 
-    // Rotation Control
-    uint32_t lastRotationTime = 0;
-    bool showUpcoming = true; // Toggle between Schedule and Stats
+// Tiger zooming in from half size, once at boot
+class ZoomScene : public Scene {
+public:
+    ZoomScene() : Scene("zoom", 4000) {}
 
-    // Sponsor Logic Variables
-    SponsorState sponsorState = SPONSOR_IDLE;
-    time_t lastSponsorRunTime = 0;
-    float sponsorScrollX = 256;
-    unsigned int sponsorListIdx = 0;
-    uint32_t sponsorWaitStart = 0; // ms
-    float sponsorListY = 64;
-    uint32_t outroStartTime = 0;
-
-    // Initialize last run time to (now - 14.5 mins) so it runs 30 seconds after boot for testing
-    time(&lastSponsorRunTime);
-    lastSponsorRunTime -= (15 * 60) - 30;
-
-    while(1) {
-        canvas_dev->fillScreen(0);
-        uint32_t nowMs = esp_timer_get_time() / 1000;
+    void update(uint32_t nowMs, uint32_t dtMs) override {
+        drawnZoom = zoom.fix() << (Q16_SHIFT - ANIM_SHIFT);
+        zoom.advance(ZOOM_SPEED, dtMs);
+    }
 
-        // --- SPONSOR CHECK ---
-        if (sponsorState == SPONSOR_IDLE) {
-            time_t nowSec;
-            time(&nowSec);
-            if (difftime(nowSec, lastSponsorRunTime) >= 15 * 60) {
-                if (isSafeForSponsors()) {
-                    sponsorState = SPONSOR_INTRO;
-                    sponsorScrollX = 256;
-                    lastSponsorRunTime = nowSec;
-                }
+    void render() override {
+        GFXcanvas16 *canvas = takeBackground();
+        int size = (64 * drawnZoom) >> Q16_SHIFT;
+        int xPos = 27 - (size / 2);
+        int yPos = 28 - (size / 2);
+        for(int r=0; r<64; r++) {
+            int y = yPos + ((r * drawnZoom) >> Q16_SHIFT);
+            for(int c=0; c<64; c++) {
+                uint16_t color = tiger_hires_map[r * 64 + c];
+                canvas->drawPixel(xPos + ((c * drawnZoom) >> Q16_SHIFT), y, color);
             }
         }
+    }
 
-        if (sponsorState != SPONSOR_IDLE) {
-            // --- SPONSOR DISPLAY LOGIC ---
-
-            if (sponsorState == SPONSOR_INTRO) {
-                // Static Header
-                canvas_dev->setFont(NULL);
-                canvas_dev->setTextColor(0xFFFF);
-
-                const char* header = SPONSOR_HEADER_TEXT;
-                int16_t x1, y1; uint16_t w, h;
-                // getTextBounds with NULL font works differently or not at all in some GFX versions,
-                // but default font is 6x8 pixels.
-                // Centering manually assuming 6px width per char
-                int len = strlen(header);
-                int w_guess = len * 6;
-                int startX = (256 - w_guess) / 2;
-                if (startX < 0) startX = 0;
-
-                canvas_dev->setCursor(startX, 5);
-                canvas_dev->print(header);
-
-                // Wait briefly then move to list
-                if (sponsorWaitStart == 0) sponsorWaitStart = nowMs;
-                if (nowMs - sponsorWaitStart > 2000) {
-                     sponsorState = SPONSOR_SHOW_LIST;
-                     sponsorListIdx = 0;
-                     sponsorListY = 90; // Start completely off screen
-                     sponsorWaitStart = 0;
-                }
-            }
-            else if (sponsorState == SPONSOR_SHOW_LIST) {
-                if (sponsorListIdx < SPONSOR_LIST.size()) {
-                    std::string name = SPONSOR_LIST[sponsorListIdx];
-                    canvas_dev->setFont(&FreeSansBold12pt7b);
-                    canvas_dev->setTextColor(0xFC00); // Orange-ish
-
-                    // Basic Word Wrap Logic
-                    // 1. Check width
-                    int16_t x1, y1; uint16_t w, h;
-                    canvas_dev->getTextBounds(name.c_str(), 0, 0, &x1, &y1, &w, &h);
-
-                    std::vector<std::string> lines;
-                    if (w > 250) {
-                        // Needs wrap. Simple split by finding middle space?
-                        // For simplicity, just split if too long.
-                        // Real wrapping requires parsing spaces.
-                        size_t splitPos = name.length() / 2;
-                        size_t spacePos = name.find(' ', splitPos);
-                         if (spacePos == std::string::npos) spacePos = name.find_last_of(' ', splitPos);
-
-                         if (spacePos != std::string::npos) {
-                             lines.push_back(name.substr(0, spacePos));
-                             lines.push_back(name.substr(spacePos + 1));
-                         } else {
-                             lines.push_back(name); // Can't split
-                         }
-                    } else {
-                        lines.push_back(name);
-                    }
+    bool finished() const override { return zoom.fix() >= ANIM_ONE; }
 
-                    int totalHeight = lines.size() * 25; // approx height with spacing
-                    float targetY = 40; // Fixed baseline "just under" header
-
-                    if (sponsorWaitStart == 0) {
-                        // Scrolling up
-                        if (sponsorListY > targetY) {
-                            sponsorListY -= 2.0;
-                        } else {
-                            // Arrived
-                            sponsorListY = targetY;
-                            sponsorWaitStart = nowMs;
-                        }
-                    } else {
-                        // Waiting
-                        if (nowMs - sponsorWaitStart > 1000) {
-                             // Done waiting, move next (up)
-                             sponsorListY -= 2.0;
-                             // Just scroll off top
-                             if (sponsorListY < -50) {
-                                 sponsorListIdx++;
-                                 sponsorListY = 90;
-                                 sponsorWaitStart = 0;
-                             }
-                        }
-                    }
+private:
+    Motion zoom{ANIM_FIX(0.5)};
+    q16_t drawnZoom = Q16_ONE / 2;
+};
 
-                    // Draw Lines
-                    int currentY = (int)sponsorListY;
-                    // Move up slightly if multi-line to center block
-                    if (lines.size() > 1) currentY -= (10 * (lines.size()-1));
-
-                    for (const auto& line : lines) {
-                        canvas_dev->getTextBounds(line.c_str(), 0, 0, &x1, &y1, &w, &h);
-                        int drawX = (256 - w) / 2;
-                        canvas_dev->setCursor(drawX, currentY);
-                        canvas_dev->print(line.c_str());
-                        currentY += 25; // Line height
-                    }
+// Tiger, team number, ticker and the schedule / last match panel
+class DashboardScene : public Scene {
+public:
+    DashboardScene() : Scene("dashboard", 3000), tigerOrange(matrix->color565(255, 140, 0)) {}
 
-                    // Draw Header ON TOP of scrolling text with black background
-                    canvas_dev->fillRect(0, 0, 256, 15, 0x0000); // Black box
-                    canvas_dev->setFont(NULL);
-                    canvas_dev->setTextColor(0xFFFF);
-                    const char* header = SPONSOR_HEADER_TEXT;
-                    int len = strlen(header);
-                    int w_guess = len * 6;
-                    int startX = (256 - w_guess) / 2;
-                    if (startX < 0) startX = 0;
-                    canvas_dev->setCursor(startX, 5);
-                    canvas_dev->print(header);
+    void enter(uint32_t nowMs) override {
+        tickerLayer->setVisible(true);
+        panelLayer->setVisible(true);
+        drawnX = INT_MIN; // Draw the ticker whatever
+    }
 
-                } else {
-                    sponsorState = SPONSOR_OUTRO;
-                    outroStartTime = nowMs;
-                }
-            }
-            else if (sponsorState == SPONSOR_OUTRO) {
-                float progress = (nowMs - outroStartTime) / 1000.0f; // seconds
-                if (progress > 4.0f) {
-                    sponsorState = SPONSOR_IDLE;
-                } else {
-                    // Static Thanks
-                    canvas_dev->setFont(&FreeSansBold18pt7b);
-                    uint16_t color = (fmod(progress, 0.5f) < 0.25f) ? 0xFFFF : 0x07E0; // White/Green flash
-                    canvas_dev->setTextColor(color);
+    void exit() override {
+        tickerLayer->setVisible(false);
+        panelLayer->setVisible(false);
+    }
 
-                    std::string thanks = "THANK YOU!!";
-                    int16_t x1, y1; uint16_t w, h;
-                    canvas_dev->getTextBounds(thanks.c_str(), 0, 0, &x1, &y1, &w, &h);
+    void update(uint32_t nowMs, uint32_t dtMs) override {
+        // --- PANEL ROTATION TIMER (7 Seconds) ---
+        if (nowMs - lastRotationTime > 7000) {
+            showUpcoming = !showUpcoming;
+            lastRotationTime = nowMs;
+        }
 
-                    canvas_dev->setCursor((256 - w)/2, 45);
-                    canvas_dev->print(thanks.c_str());
-                }
+        // --- Robust Ticker Logic (Queue based) ---
+        if (ticker.size() == 0) refreshTicker();
+
+        // A step for every TICKER_STEP_MS gone, however the time was split into frames
+        stepMs += dtMs;
+        while (stepMs >= TICKER_STEP_MS) {
+            stepMs -= TICKER_STEP_MS;
+            scrollX -= TICKER_STEP_PX;
+
+            // Handover: When msg1 clears the screen, msg2 carries on from where it's got to
+            if (scrollX < -(ticker[currentMsgIdx].width + GAP)) {
+                scrollX += ticker[currentMsgIdx].width + GAP;
+                currentMsgIdx = nextMsgIdx;
+                nextMsgIdx = (nextMsgIdx + 1) % ticker.size();
+                if (currentMsgIdx == 0) refreshTicker(); // Update data
             }
-
-            // Draw Green Pulsing Border LAST (on top of everything)
-            pulseIdx += 0.3; // Faster pulse
-            uint8_t p = 150 + (int)(100 * sin(pulseIdx));
-            uint16_t pColor = matrix->color565(0, p, 0); // Green
-            canvas_dev->drawRect(0, 0, 256, 64, pColor);
-            canvas_dev->drawRect(1, 1, 254, 62, pColor);
         }
+    }
 
-        // Only run normal logic if IDLE
-        if (sponsorState == SPONSOR_IDLE) {
-
-        // --- 1. PANEL ROTATION TIMER (10 Seconds) ---
-        if (nowMs - lastRotationTime > 7000) {
-            showUpcoming = !showUpcoming;
-            lastRotationTime = nowMs;
+    void render() override {
+        // 1. Static Background (Tiger, Team Number, Separators, Labels, Rank)
+        bool hasStats = (model->matchesCompleted > 0);
+        if (!bgValid || bgUpcoming != showUpcoming || bgHasStats != hasStats) {
+            renderBackground(showUpcoming, hasStats, tigerOrange);
         }
 
-        // --- A. PROVISIONING & RESET CHECK ---
-        bool is_prov = true;
-        int prov_check_counter = 0;
-        if (prov_check_counter++ > 200) { // Only check every ~5 seconds
-            wifi_prov_mgr_is_provisioned(&is_prov);
-            prov_check_counter = 0;
+        // 2. Ticker, only redrawn when it's stepped
+        if (scrollX != drawnX || currentMsgIdx != drawnMsgIdx) {
+            GFXcanvas16 *canvas = tickerLayer->canvas;
+            const LayerRect &clip = tickerLayer->canvas->clip;
+            uint16_t color = 0xFFFF;
+            canvas->fillScreen(0);
+            canvas->setFont(&FreeSans9pt7b);
+
+            // Message 1, then Message 2 following it
+            int x = scrollX;
+            ticker.draw(canvas, currentMsgIdx, x, 60, color, clip.x, clip.x + clip.w);
+            ticker.draw(canvas, nextMsgIdx, x + ticker[currentMsgIdx].width + GAP, 60, color, clip.x, clip.x + clip.w);
+            tickerLayer->markDirty();
+
+            drawnX = scrollX;
+            drawnMsgIdx = currentMsgIdx;
         }
 
-        if (gpio_get_level(GPIO_NUM_7) == 0) { // Button Pressed
-            if (buttonHoldStart == 0) buttonHoldStart = esp_timer_get_time() / 1000;
-            uint32_t holdTime = (esp_timer_get_time() / 1000) - buttonHoldStart;
-
-            if (holdTime > 50) {
-                isResetting = true;
-                canvas_dev->setFont(NULL);
-                canvas_dev->setTextColor(0xF800); // Red
-                canvas_dev->setCursor(80, 25);
-                canvas_dev->print("HOLD TO RESET:");
-                canvas_dev->setCursor(110, 35);
-                canvas_dev->print(3 - (holdTime / 1000));
+        // 3. Side Panel (Schedule or Last Match), re-recorded on a new model or view.
+        // Only the parts that come out different are cleared, replayed and recomposited.
+        if (model->version != panelVersion || showUpcoming != panelUpcoming) {
+            DisplayList next;
+            recordSidePanel(next, showUpcoming);
+
+            std::vector<LayerRect> changed;
+            DisplayList::diff(panelList, next, changed);
+            for (const LayerRect &r : changed) {
+                panelLayer->canvas->fillRect(r.x, r.y, r.w, r.h, 0);
             }
-            if (holdTime > 3000) {
-                nvs_flash_erase();
-                esp_restart();
+            next.replay(panelLayer->canvas, changed);
+            for (const LayerRect &r : changed) {
+                panelLayer->markDirty(r.x, r.y, r.w, r.h);
             }
-        } else {
-            buttonHoldStart = 0;
-            isResetting = false;
+
+            panelList = next;
+            panelVersion = model->version;
+            panelUpcoming = showUpcoming;
         }
+    }
 
-        // --- B. MAIN DRAWING LOGIC (Only if not resetting) ---
-        if (!isResetting) {
-            if (showZoom) {
-                // Zooming Intro Animation
-                int size = (int)(64 * zoom);
-                int xPos = 27 - (size / 2);
-                int yPos = 28 - (size / 2);
-                for(int r=0; r<64; r++) {
-                    for(int c=0; c<64; c++) {
-                        uint16_t color = tiger_hires_map[r * 64 + c];
-                        canvas_dev->drawPixel(xPos + (c*zoom), yPos + (r*zoom), color);
-                    }
-                }
-                zoom += 0.08f;
-                if (zoom >= 1.0f) { showZoom = false; }
-            } else {
-                // 1. Draw Tiger
-                drawTiger(canvas_dev, -5, -3);
-                // 2. Draw Team Number
-                canvas_dev->setFont(&FreeSansBold18pt7b);
-                canvas_dev->setTextColor(tigerOrange);
-                canvas_dev->setCursor(52, 40);
-                canvas_dev->print("5459");
-
-                // 3. Robust Ticker Logic (Queue based)
-                if (tickerQueue.empty()) refreshTickerQueue();
-
-                canvas_dev->setFont(&FreeSans9pt7b);
-                canvas_dev->setTextWrap(false);
-                canvas_dev->setTextColor(is_prov ? white : 0xF800);
-
-                std::string msg1 = tickerQueue[currentMsgIdx];
-                std::string msg2 = tickerQueue[nextMsgIdx];
-
-                // Draw Message 1
-                canvas_dev->setCursor((int)scrollX, 60);
-                canvas_dev->print(msg1.c_str());
-
-                // Find where Message 1 ends
-                int16_t x1, y1; uint16_t w1, h1;
-                canvas_dev->getTextBounds(msg1.c_str(), 0, 0, &x1, &y1, &w1, &h1);
-
-                // Draw Message 2 following msg1
-                canvas_dev->setCursor((int)scrollX + w1 + GAP, 60);
-                canvas_dev->print(msg2.c_str());
-
-                scrollX -= 2.0f; // Scrolling Speed
-                canvas_dev->fillRect(129, 45, 127, 17, 0);
-                // Handover: When msg1 clears the screen
-                if (scrollX < -(w1 + GAP)) {
-                    scrollX = 0;
-                    currentMsgIdx = nextMsgIdx;
-                    nextMsgIdx = (nextMsgIdx + 1) % tickerQueue.size();
-                    if (currentMsgIdx == 0) refreshTickerQueue(); // Update data
-                }
-                // 1. Draw a vertical separator line
-                canvas_dev->drawFastVLine(130, 5, 54, 0x3186);
+    // The next ticker step, or the panel rotating if that's sooner
+    uint32_t msUntilChange(uint32_t nowMs) const override {
+        uint32_t wait = TICKER_STEP_MS - stepMs;
+        uint32_t shown = nowMs - lastRotationTime;
+        if (shown <= 7000 && 7001 - shown < wait) wait = 7001 - shown;
+        return wait;
+    }
 
-                canvas_dev->setFont(NULL); // Small fixed font
-                if (showUpcoming) {
-                    // 1. HEADER: Currently Playing
-                    canvas_dev->setTextColor(0xFFE0); // Yellow
-                    canvas_dev->setCursor(138, 5);
-                    canvas_dev->print("NOW ON FIELD: Q");
-                    canvas_dev->print(currentlyPlaying);
+private:
+    const uint16_t tigerOrange;
+    static const int GAP = 60;
 
-                    canvas_dev->drawFastHLine(135, 14, 115, 0x3186); // Header separator
+    int currentMsgIdx = 0;
+    int nextMsgIdx = 1;
+    int scrollX = 128;
+    uint32_t stepMs = 0; // Towards the next step
+    int drawnX = INT_MIN;
+    int drawnMsgIdx = 0;
+
+    uint32_t lastRotationTime = 0;
+    bool showUpcoming = true; // Toggle between Schedule and Stats
+
+    DisplayList panelList;
+    uint32_t panelVersion = 0; // Never published, so the first frame records
+    bool panelUpcoming = false;
+};
+
+// Factory reset countdown while the button is held, interrupting whatever was on
+class ResetScene : public Scene {
+public:
+    ResetScene() : Scene("reset", 1000) {}
+
+    void update(uint32_t nowMs, uint32_t dtMs) override {
+        released = (gpio_get_level(GPIO_NUM_7) != 0);
+        holdTime = nowMs - buttonHoldStart;
+
+        if (!released && holdTime > 3000) {
+            nvs_flash_erase();
+            esp_restart();
+        }
+    }
 
-                    // 2. TABLE HEADERS (Labels)
-                    canvas_dev->setTextColor(0x7BEF); // Gray
-                    canvas_dev->setCursor(138, 18);
-                    canvas_dev->print("UPCOMING");
+    void render() override {
+        GFXcanvas16 *canvas = takeBackground();
+        canvas->setFont(NULL);
+        canvas->setTextColor(0xF800); // Red
+        canvas->setCursor(80, 25);
+        canvas->print("HOLD TO RESET:");
+        canvas->setCursor(110, 35);
+        canvas->print(3 - (holdTime / 1000));
+    }
 
+    bool finished() const override { return released; }
 
-                    // 3. COLOR-CODED MATCH LIST
-                    for (int i = 0; i < 3; i++) {
-                        int yOff = 29 + (i * 10); // 10 pixels spacing for better legibility
+private:
+    bool released = false;
+    uint32_t holdTime = 0;
+};
 
-                        // Match Type and Number (Color-coded by Alliance)
-                        canvas_dev->setTextColor(schedule[i].color);
-                        canvas_dev->setCursor(138, yOff);
+// Sponsor thank you: header, each sponsor scrolling up in turn, then a flashing THANK YOU
+class SponsorScene : public Scene {
+public:
+    SponsorScene() : Scene("sponsors", 4000) {}
 
-                        // Example: "Q42"
-                        canvas_dev->print(schedule[i].type);
-                        canvas_dev->print(schedule[i].number);
+    void enter(uint32_t nowMs) override {
+        sponsorState = SPONSOR_INTRO;
+        sponsorWaitStart = 0;
+        drawnState = SPONSOR_IDLE; // Draw the first frame whatever
+        headerLayer->setVisible(true);
+    }
 
-                        // Optional: Draw a small dot or dash in the alliance color to the left
-                        // to make it "pop" even more
-                        canvas_dev->drawFastVLine(134, yOff - 1, 7, schedule[i].color);
+    void exit() override {
+        headerLayer->setVisible(false);
+    }
 
-                        // Est Time (Placeholder - assuming you add 'est_time' to your struct later)
-                        canvas_dev->setTextColor(white);
-                        canvas_dev->setCursor(160, yOff);
-                        canvas_dev->print("-10:45A");
+    void update(uint32_t nowMs, uint32_t dtMs) override {
+        this->nowMs = nowMs;
+
+        if (sponsorState == SPONSOR_INTRO) {
+            // Wait briefly then move to list
+            if (sponsorWaitStart == 0) sponsorWaitStart = nowMs;
+            if (nowMs - sponsorWaitStart > 2000) {
+                 sponsorState = SPONSOR_SHOW_LIST;
+                 sponsorListIdx = 0;
+                 wrapLines(SPONSOR_LIST[0].c_str());
+                 sponsorListY.set(ANIM_FIX(90)); // Start completely off screen
+                 sponsorWaitStart = 0;
+            }
+        }
+        else if (sponsorState == SPONSOR_SHOW_LIST) {
+            if (sponsorListIdx < SPONSOR_LIST.size()) {
+                int targetY = 40; // Fixed baseline "just under" header
+
+                if (sponsorWaitStart == 0) {
+                    // Scrolling up
+                    if (sponsorListY.fix() > ANIM_FIX(targetY)) {
+                        sponsorListY.advance(-SPONSOR_SPEED, dtMs);
+                    } else {
+                        // Arrived
+                        sponsorListY.set(ANIM_FIX(targetY));
+                        sponsorWaitStart = nowMs;
                     }
                 } else {
-                    // --- LAST MATCH STATS VIEW ---
-                    if (matchesCompleted == 0) {
-                        canvas_dev->setCursor(145, 30);
-                        canvas_dev->print("AWAITING DATA...");
-                    } else {
-                        GameScore last = matchHistory[matchesCompleted - 1];
-                        canvas_dev->setTextColor(0x07FF); // Cyan
-                        canvas_dev->setCursor(138, 5);
-                        canvas_dev->print("LAST MATCH: Q"); canvas_dev->print(last.matchNum);
-                        canvas_dev->drawFastHLine(135, 14, 115, 0x3186);
-
-                        canvas_dev->setCursor(138, 18);
-                        canvas_dev->setTextColor(0xF81F); canvas_dev->print("AUTO:");
-                        canvas_dev->setTextColor(white); canvas_dev->print(" F"); canvas_dev->print(last.autoFuel);
-                        canvas_dev->print(" C"); canvas_dev->print(last.autoClimb);
-
-                        canvas_dev->setCursor(138, 27);
-                        canvas_dev->setTextColor(0x07E0); canvas_dev->print("TELE:");
-                        canvas_dev->setTextColor(white); canvas_dev->print(" F"); canvas_dev->print(last.teleFuel);
-                        if (last.fuelRP) { canvas_dev->setTextColor(0xFBE0); canvas_dev->print("**"); }
-
-                        canvas_dev->setCursor(138, 36);
-                        canvas_dev->setTextColor(white); canvas_dev->print("CLIMB:");
-                        canvas_dev->print(last.teleClimb/10);
-                        if (last.towerRP) { canvas_dev->setTextColor(0x07FF); canvas_dev->print("*"); }
-
-                        canvas_dev->setCursor(138, 45);
-                        canvas_dev->setTextColor(0xF800); canvas_dev->print("FOUL: ");
-                        canvas_dev->setTextColor(white); canvas_dev->print(last.foulPointsAwarded);
-
-                        canvas_dev->setCursor(138, 54);
-                        canvas_dev->setTextColor(0xFFE0); canvas_dev->print("SCORE: ");
-                        canvas_dev->print(last.totalScore);
+                    // Waiting
+                    if (nowMs - sponsorWaitStart > 1000) {
+                         // Done waiting, move next (up)
+                         sponsorListY.advance(-SPONSOR_SPEED, dtMs);
+                         // Just scroll off top
+                         if (sponsorListY.pixel() < -50) {
+                             sponsorListIdx++;
+                             if (sponsorListIdx < SPONSOR_LIST.size()) wrapLines(SPONSOR_LIST[sponsorListIdx].c_str());
+                             sponsorListY.set(ANIM_FIX(90));
+                             sponsorWaitStart = 0;
+                         }
                     }
                 }
-                // B. RANK INFO (Panel 4)
-                canvas_dev->setFont(NULL);
-                canvas_dev->setTextColor(0x7BEF);
-                canvas_dev->setCursor(220, 18);
-                canvas_dev->print("RANK");
+            } else {
+                sponsorState = SPONSOR_OUTRO;
+                outroStartTime = nowMs;
+            }
+        }
+        else if (sponsorState == SPONSOR_OUTRO) {
+            if (nowMs - outroStartTime > 4000) {
+                sponsorState = SPONSOR_IDLE;
+            }
+        }
+    }
 
-                canvas_dev->setFont(&FreeSansBold12pt7b);
-                canvas_dev->setTextColor(0xFFE0); // Yellow
-                canvas_dev->setCursor(215, 45);
-                canvas_dev->print("12");
+    void render() override {
+        // Nothing to redraw unless the text moved or the pulse / flash colour stepped
+        uint16_t pColor = greenPulse(nowMs);
+        uint16_t flash = flashColor();
+        int listY = sponsorListY.pixel();
+        if (sponsorState == drawnState && sponsorListIdx == drawnIdx && listY == drawnY &&
+            pColor == drawnPulse && flash == drawnFlash) {
+            return;
+        }
+        drawnState = sponsorState;
+        drawnIdx = sponsorListIdx;
+        drawnY = listY;
+        drawnPulse = pColor;
+        drawnFlash = flash;
+
+        GFXcanvas16 *canvas = takeBackground();
+        GFXcanvas16 *header = headerLayer->canvas;
+        header->fillScreen(0);
+        headerLayer->markDirty();
+
+        if (sponsorState == SPONSOR_INTRO) {
+            // Static Header
+            drawSponsorHeader(header);
+        }
+        else if (sponsorState == SPONSOR_SHOW_LIST) {
+            canvas->setFont(&FreeSansBold12pt7b);
+            canvas->setTextColor(0xFC00); // Orange-ish
+
+            // Draw Lines
+            int currentY = listY;
+            // Move up slightly if multi-line to center block
+            if (lineCount > 1) currentY -= (10 * (lineCount - 1));
+
+            for (int i = 0; i < lineCount; i++) {
+                canvas->setCursor(lineX[i], currentY);
+                canvas->print(lines[i]);
+                currentY += 25; // Line height
+            }
+
+            // Header stays on top of the scrolling text
+            drawSponsorHeader(header);
+        }
+        else if (sponsorState == SPONSOR_OUTRO) {
+            // Static Thanks
+            canvas->setFont(&FreeSansBold18pt7b);
+            canvas->setTextColor(flash);
 
-                // 1. Draw Static Tiger & Pulsing Border
+            const char *thanks = "THANK YOU!!";
+            int16_t x1, y1; uint16_t w, h;
+            canvas->getTextBounds(thanks, 0, 0, &x1, &y1, &w, &h);
 
+            canvas->setCursor((256 - w)/2, 45);
+            canvas->print(thanks);
+        }
+
+        // Green Pulsing Border on top of everything (the header covers the top of the background)
+        canvas->drawRect(0, 0, 256, 64, pColor);
+        canvas->drawRect(1, 1, 254, 62, pColor);
+        header->drawRect(0, 0, 256, 64, pColor);
+        header->drawRect(1, 1, 254, 62, pColor);
+    }
+
+    bool finished() const override { return sponsorState == SPONSOR_IDLE; }
+    bool wantsOverlays() const override { return false; }
+
+    // Sleeps through the intro, the pause under the header and the flashing, bar the pulse
+    uint32_t msUntilChange(uint32_t nowMs) const override {
+        uint32_t wait = 0;
+        if (sponsorState == SPONSOR_INTRO) {
+            uint32_t waited = nowMs - sponsorWaitStart;
+            if (waited <= 2000) wait = 2001 - waited;
+        }
+        else if (sponsorState == SPONSOR_SHOW_LIST && sponsorWaitStart != 0) {
+            uint32_t waited = nowMs - sponsorWaitStart;
+            if (waited <= 1000) wait = 1001 - waited;
+        }
+        else if (sponsorState == SPONSOR_OUTRO) {
+            uint32_t elapsed = nowMs - outroStartTime;
+            if (elapsed <= 4000) wait = (elapsed == 4000) ? 1 : 250 - (elapsed % 250);
+        }
+        if (wait == 0) return 0;
+
+        uint32_t pulse = msUntilPulseChange(nowMs, greenPulse);
+        return (pulse < wait) ? pulse : wait;
+    }
+
+private:
+    uint16_t flashColor() const {
+        if (sponsorState != SPONSOR_OUTRO) return 0;
+        return ((nowMs - outroStartTime) % 500 < 250) ? 0xFFFF : 0x07E0; // White/Green flash
+    }
+
+    // Word wrap, once per sponsor: a name too wide for the panel is split at the first space
+    // after its middle (or the last one before it), each line centred
+    void wrapLines(const char *name) {
+        bgLayer->canvas->setFont(&FreeSansBold12pt7b);
+        lineCount = 0;
+
+        int len = strlen(name);
+        int spacePos = -1;
+        if (textWidth(name) > 250) {
+            for (int i = len / 2; i < len && spacePos < 0; i++) {
+                if (name[i] == ' ') spacePos = i;
             }
+            for (int i = len / 2; i >= 0 && spacePos < 0; i--) {
+                if (name[i] == ' ') spacePos = i;
+            }
+        }
+
+        if (spacePos >= 0) {
+            addLine(name, spacePos);
+            addLine(name + spacePos + 1, len - spacePos - 1);
+        } else {
+            addLine(name, len); // Fits, or can't split
         }
+    }
+
+    void addLine(const char *text, int len) {
+        char *line = lines[lineCount];
+        snprintf(line, sizeof(lines[0]), "%.*s", len, text);
+        lineX[lineCount++] = (256 - textWidth(line)) / 2;
+    }
+
+    static int textWidth(const char *text) {
+        int16_t x1, y1; uint16_t w, h;
+        bgLayer->canvas->getTextBounds(text, 0, 0, &x1, &y1, &w, &h);
+        return w;
+    }
 
-        // --- C. PERMANENT OVERLAYS (Clock & Status) ---
+    SponsorState sponsorState = SPONSOR_IDLE;
+    unsigned int sponsorListIdx = 0;
+    uint32_t sponsorWaitStart = 0; // ms
+    Motion sponsorListY{ANIM_FIX(64)};
+    uint32_t outroStartTime = 0;
+    uint32_t nowMs = 0;
+    char lines[2][40];
+    int16_t lineX[2];
+    int lineCount = 0;
+
+    // What the last render drew
+    SponsorState drawnState = SPONSOR_IDLE;
+    unsigned int drawnIdx = 0;
+    int drawnY = 0;
+    uint16_t drawnPulse = 0;
+    uint16_t drawnFlash = 0;
+};
+
+// Clock and Wi-Fi status in the top left, on top of every scene that wants overlays
+class ClockOverlay : public Scene {
+public:
+    ClockOverlay() : Scene("clock", 500) {}
+
+    void enter(uint32_t nowMs) override {
+        clockLayer->setVisible(true);
+        statusLayer->setVisible(true);
+    }
+
+    void exit() override {
+        clockLayer->setVisible(false);
+        statusLayer->setVisible(false);
+    }
+
+    void update(uint32_t nowMs, uint32_t dtMs) override {
         time_t now;
-        struct tm timeinfo;
         time(&now);
         localtime_r(&now, &timeinfo);
 
-        // Clock Display
-        canvas_dev->setFont(NULL);
+        wifi_ap_record_t ap_info;
+        wifiDown = (esp_wifi_sta_get_ap_info(&ap_info) != ESP_OK);
+    }
+
+    void render() override {
+        // Clock Display, redrawn when the minute, colon or sync state changes
+        uint16_t white = 0xFFFF;
         uint16_t clockColor = (timeinfo.tm_year > 120) ? white : 0xF800;
-        canvas_dev->setTextColor(clockColor);
-        int hour = timeinfo.tm_hour % 12;
-        if (hour == 0) hour = 12;
-        int tX = 91;
-        canvas_dev->setCursor(tX, 2);
-        canvas_dev->print(hour);
-
-        int colonX = (hour >= 10) ? tX + 12 : tX + 6;
-        if (timeinfo.tm_sec % 2 == 0) {
-            canvas_dev->drawPixel(colonX + 1, 4, clockColor);
-            canvas_dev->drawPixel(colonX + 1, 6, clockColor);
+        int clockNow = ((timeinfo.tm_hour * 60 + timeinfo.tm_min) * 2 + (timeinfo.tm_sec % 2)) * 2 + (clockColor == white);
+        if (clockNow != clockSig) {
+            GFXcanvas16 *clock = clockLayer->canvas;
+            clock->fillScreen(0);
+            clock->setFont(NULL);
+            clock->setTextColor(clockColor);
+            int hour = timeinfo.tm_hour % 12;
+            if (hour == 0) hour = 12;
+            int tX = 91;
+            clock->setCursor(tX, 2);
+            clock->print(hour);
+
+            int colonX = (hour >= 10) ? tX + 12 : tX + 6;
+            if (timeinfo.tm_sec % 2 == 0) {
+                clock->drawPixel(colonX + 1, 4, clockColor);
+                clock->drawPixel(colonX + 1, 6, clockColor);
+            }
+            clock->setCursor(colonX + 4, 2);
+            if (timeinfo.tm_min < 10) clock->print("0");
+            clock->print(timeinfo.tm_min);
+            clock->setCursor(120, 2);
+            clock->print((timeinfo.tm_hour >= 12) ? "P" : "A");
+            clockLayer->markDirty();
+            clockSig = clockNow;
         }
-        canvas_dev->setCursor(colonX + 4, 2);
-        if (timeinfo.tm_min < 10) canvas_dev->print("0");
-        canvas_dev->print(timeinfo.tm_min);
-        canvas_dev->setCursor(120, 2);
-        canvas_dev->print((timeinfo.tm_hour >= 12) ? "P" : "A");
 
         // Wi-Fi Blink Indicator
-        wifi_ap_record_t ap_info;
-        if (esp_wifi_sta_get_ap_info(&ap_info) != ESP_OK) {
-            if (timeinfo.tm_sec % 2 == 0) canvas_dev->fillCircle(5, 3, 1, 0xF800);
+        int status = (wifiDown && timeinfo.tm_sec % 2 == 0) ? 1 : 0;
+        if (status != statusSig) {
+            statusLayer->canvas->fillScreen(0);
+            if (status) statusLayer->canvas->fillCircle(5, 3, 1, 0xF800);
+            statusLayer->markDirty();
+            statusSig = status;
         }
+    }
+
+    // The colon and the Wi-Fi indicator blink on the second
+    uint32_t msUntilChange(uint32_t nowMs) const override {
+        struct timeval tv;
+        gettimeofday(&tv, NULL);
+        return 1000 - (tv.tv_usec / 1000);
+    }
+
+private:
+    struct tm timeinfo = {};
+    bool wifiDown = false;
+    int clockSig = -1;
+    int statusSig = -1;
+};
+
+// Pac-Man chase round the edge every couple of minutes, a pulsing orange border otherwise
+class BorderOverlay : public Scene {
+public:
+    BorderOverlay() : Scene("border", 1500) {}
+
+    void enter(uint32_t nowMs) override {
+        borderLayer->setVisible(true);
+    }
+
+    void exit() override {
+        borderLayer->setVisible(false);
+    }
 
-        // --- PAC-MAN BORDER ANIMATION ---
+    void update(uint32_t nowMs, uint32_t dtMs) override {
+        this->nowMs = nowMs;
+        this->dtMs = dtMs;
         if (!borderActive && (nowMs - lastBorderStartTime > 120000)) {
             reset_pacman_game(nowMs);
         }
+    }
 
+    void render() override {
+        GFXcanvas16 *border = borderLayer->canvas;
         if (borderActive) {
-            run_pacman_cycle(canvas_dev, nowMs);
+            border->fillScreen(BORDER_KEY);
+            run_pacman_cycle(border, nowMs, dtMs);
+            drawnColor = -1;
+            markBorderDirty();
         } else {
-            //  Draw Pulsing Border
+            //  Draw Pulsing Border, when the colour has actually stepped
+            uint16_t pColor = orangePulse(nowMs);
+            if (pColor != drawnColor) {
+                border->fillScreen(BORDER_KEY);
+                border->drawRect(0, 0, 256, 64, pColor);
+                border->drawRect(1, 1, 254, 62, pColor);
+                drawnColor = pColor;
+                markBorderDirty();
+            }
+        }
+    }
+
+    // Pac-Man moves every frame, the pulse only every so often
+    uint32_t msUntilChange(uint32_t nowMs) const override {
+        if (borderActive || drawnColor != orangePulse(nowMs)) return 0;
+
+        uint32_t ms = msUntilPulseChange(nowMs, orangePulse);
+        uint32_t sincePacman = nowMs - lastBorderStartTime;
+        if (sincePacman <= 120000 && 120001 - sincePacman < ms) ms = 120001 - sincePacman;
+        return ms;
+    }
+
+private:
+    uint32_t nowMs = 0;
+    uint32_t dtMs = 0;
+    int32_t drawnColor = -1; // Nothing yet
+};
+
+void matrix_task(void *pvParameters) {
+    // Anything that changes the picture wakes us: new data (matrix_wake) or a button press
+    matrixTask = xTaskGetCurrentTaskHandle();
+    gpio_set_intr_type(GPIO_NUM_7, GPIO_INTR_NEGEDGE);
+    esp_err_t err = gpio_install_isr_service(0);
+    if (err == ESP_OK || err == ESP_ERR_INVALID_STATE) { // Already installed is fine
+        gpio_isr_handler_add(GPIO_NUM_7, button_isr, NULL);
+    } else {
+        printf("DISPLAY: no button interrupt (%d), the button is only seen when the display wakes\n", err);
+    }
+
+    // 1. Initialize Ticker
+    model = &displayModel.read();
+    refreshTicker();
+
+    // Layers, composited into canvas_dev
+    Compositor compositor(canvas_dev, 256, 64);
+    bgLayer     = compositor.addLayer(0, 0, 256, 64, 0);
+    tickerLayer = compositor.addLayer(0, 45, 129, 19, 1); // Stops short of the side panels
+    panelLayer  = compositor.addLayer(131, 0, 125, 64, 1);
+    clockLayer  = compositor.addLayer(91, 2, 36, 8, 2);
+    statusLayer = compositor.addLayer(4, 2, 3, 3, 2);
+    headerLayer = compositor.addLayer(0, 0, 256, 15, 3); // Sponsor list scrolls out underneath
+    borderLayer = compositor.addLayer(0, 0, 256, 64, 4);
+    tickerLayer->setColorKey(0);
+    panelLayer->setColorKey(0);
+    clockLayer->setColorKey(0);
+    statusLayer->setColorKey(0);
+    borderLayer->setColorKey(BORDER_KEY);
+    borderLayer->canvas->fillScreen(BORDER_KEY);
+    init_pacman_engine(borderLayer->canvas->width(), borderLayer->canvas->height());
+    tickerLayer->setVisible(false);
+    panelLayer->setVisible(false);
+    headerLayer->setVisible(false);
+
+    // Scenes
+    ZoomScene zoomScene;
+    DashboardScene dashboardScene;
+    ResetScene resetScene;
+    SponsorScene sponsorScene;
+    ClockOverlay clockOverlay;
+    BorderOverlay borderOverlay;
+
+    SceneManager scenes;
+    scenes.setHome(&dashboardScene);
+    scenes.addOverlay(&clockOverlay);
+    scenes.addOverlay(&borderOverlay);
+    scenes.setScene(&zoomScene, esp_timer_get_time() / 1000);
+
+    // Duty cycle, reported every DUTY_REPORT_MS
+    uint32_t compositedPixels = 0;
+    uint32_t frames = 0;
+    uint32_t framesSent = 0;
+    uint64_t busyUs = 0;
+    uint32_t reportStartMs = esp_timer_get_time() / 1000;
 
-            pulseIdx += 0.1;
-            uint8_t p = 150 + (int)(100 * sin(pulseIdx));
-            uint16_t pColor = matrix->color565(p, (p * 140 / 255), 0);
-            canvas_dev->drawRect(0, 0, 256, 64, pColor);
-            canvas_dev->drawRect(1, 1, 254, 62, pColor);
+    // Initialize last run time to (now - 14.5 mins) so it runs 30 seconds after boot for testing
+    time_t lastSponsorRunTime = 0;
+    time(&lastSponsorRunTime);
+    lastSponsorRunTime -= (15 * 60) - 30;
+
+    while(1) {
+        int64_t wakeUs = esp_timer_get_time();
+        uint32_t nowMs = wakeUs / 1000;
+        Scene *current = scenes.current();
+        model = &displayModel.read();
+
+        // --- SPONSOR CHECK ---
+        if (current == &dashboardScene) {
+            time_t nowSec;
+            time(&nowSec);
+            if (nowSec - lastSponsorRunTime >= 15 * 60) {
+                if (isSafeForSponsors()) {
+                    scenes.setScene(&sponsorScene, nowMs);
+                    lastSponsorRunTime = nowSec;
+                }
+            }
         }
-        } // End of sponsorState == SPONSOR_IDLE check
-
-        // --- D. FINAL RENDER ---
-        uint16_t *buf = canvas_dev->getBuffer();
-        for(int y = 0; y < 64; y++) {
-        // We point to the start of the current row in the canvas buffer
-        uint16_t* row_ptr = &buf[y * 256];
-
-        // Most HUB75 libraries have a drawLine or drawIcon function,
-        // but the fastest way without custom hacking is this:
-        for(int x = 0; x < 256; x++) {
-            // Only draw if the pixel isn't black to save internal logic time
-            if (row_ptr[x] != 0) {
-                matrix->drawPixel(x, y, row_ptr[x]);
-            } else {
-                // If the pixel is black, we still need to clear it on the matrix
-                matrix->drawPixel(x, y, 0);
+
+        // --- RESET CHECK ---
+        if (current != &sponsorScene) {
+            if (gpio_get_level(GPIO_NUM_7) == 0) { // Button Pressed
+                if (buttonHoldStart == 0) buttonHoldStart = nowMs;
+                if (nowMs - buttonHoldStart > 50 && current != &resetScene) {
+                    scenes.pushScene(&resetScene, nowMs);
                 }
+            } else {
+                buttonHoldStart = 0;
             }
         }
-        vTaskDelay(pdMS_TO_TICKS(25));
+
+        scenes.frame(nowMs);
+
+        // --- FINAL RENDER ---
+        // Only the regions some layer changed are recomposited, and nothing is sent if none did.
+        // Encode the whole canvas in one go, racing the DMA scan so the ticker doesn't tear
+        uint32_t pixels = compositor.composite();
+        uint64_t sleptUs = matrix->getBeamRaceSleepUs();
+        if (pixels > 0) {
+            matrix->drawFrameRGB565(canvas_dev->getBuffer());
+            framesSent++;
+            boot_mark(BOOT_FIRST_PIXEL);
+        }
+
+        // --- SLEEP ---
+        // Until something on screen is due to change, or we're woken for new data or the button
+        uint32_t sleepMs = scenes.msUntilChange(nowMs);
+        if (buttonHoldStart != 0) sleepMs = 0; // Timing the hold
+        if (sleepMs < FRAME_MS) sleepMs = FRAME_MS;
+        if (sleepMs > MAX_SLEEP_MS) sleepMs = MAX_SLEEP_MS;
+
+        compositedPixels += pixels;
+        frames++;
+        // Not counting the time drawFrameRGB565 was asleep waiting for the scanner
+        busyUs += esp_timer_get_time() - wakeUs - (matrix->getBeamRaceSleepUs() - sleptUs);
+        uint32_t elapsedMs = nowMs - reportStartMs;
+        if (elapsedMs >= DUTY_REPORT_MS) {
+            uint32_t permille = (uint32_t)(busyUs / elapsedMs); // us per ms -> parts per thousand
+            printf("DISPLAY: %lu frames, %lu sent in %lu ms, %lu.%lu%% busy, %lu px/frame recomposited\n",
+                   (unsigned long)frames, (unsigned long)framesSent, (unsigned long)elapsedMs,
+                   (unsigned long)(permille / 10), (unsigned long)(permille % 10),
+                   (unsigned long)(compositedPixels / frames));
+            compositedPixels = 0;
+            frames = 0;
+            framesSent = 0;
+            busyUs = 0;
+            reportStartMs = nowMs;
+        }
+
+        ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(sleepMs));
     }
 }
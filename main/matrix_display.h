@@ -2,6 +2,7 @@
 #define MATRIX_DISPLAY_H
 
 void matrix_task(void *pvParameters);
+void matrix_wake(); // Redraw now rather than when the display next expects a change
 void addMatchResult(int mNum, int aF, int aC, int tF, int tC, int fouls, int total, bool fRP, bool tRP);
 
 #endif // MATRIX_DISPLAY_H
@@ -0,0 +1,243 @@
+#include "model_snapshot.h"
+#include "esp_spiffs.h"
+#include "esp_rom_crc.h"
+#include "esp_timer.h"
+#include <stdio.h>
+#include <string.h>
+
+#define SNAPSHOT_TEMP   SNAPSHOT_MOUNT "/model.tmp"
+#define SNAPSHOT_HEADER 12
+
+// Biggest the encoding below gets: sources, a full history, the schedule, playing, the longest event name and dates
+static_assert(SNAPSHOT_HEADER + 8 + 1 + 12 * 15 + 3 * 13 + 2 + 1 + sizeof(DisplayModel::nextEventName) - 1 + 16 <= SNAPSHOT_MAX,
+              "SNAPSHOT_MAX is too small for the encoding");
+
+static bool mounted = false;
+static uint8_t lastSaved[SNAPSHOT_MAX]; // What's in flash, so unchanged models aren't written again
+static size_t lastSavedLen = 0;
+
+// --- Encoding ---
+class SnapshotWriter {
+public:
+    explicit SnapshotWriter(uint8_t *buf) : buf(buf) {}
+
+    void u8(uint8_t v) { buf[len++] = v; }
+    void u16(uint16_t v) { u8(v & 0xFF); u8(v >> 8); }
+    void u32(uint32_t v) { u16(v & 0xFFFF); u16(v >> 16); }
+    void i16(int v) { u16((uint16_t)(int16_t)(v < INT16_MIN ? INT16_MIN : v > INT16_MAX ? INT16_MAX : v)); }
+    void i64(int64_t v) { u32((uint32_t)v); u32((uint32_t)((uint64_t)v >> 32)); }
+    void bytes(const void *p, size_t n) { memcpy(&buf[len], p, n); len += n; }
+
+    uint8_t *buf;
+    size_t len = 0;
+};
+
+class SnapshotReader {
+public:
+    SnapshotReader(const uint8_t *buf, size_t len) : buf(buf), len(len) {}
+
+    // Reading past the end gives zeros and sets overrun, checked once at the end
+    uint8_t u8() { if (pos < len) return buf[pos++]; overrun = true; return 0; }
+    uint16_t u16() { uint16_t lo = u8(); return lo | (uint16_t)(u8() << 8); }
+    uint32_t u32() { uint32_t lo = u16(); return lo | ((uint32_t)u16() << 16); }
+    int i16() { return (int16_t)u16(); }
+    int64_t i64() { uint64_t lo = u32(); return (int64_t)(lo | ((uint64_t)u32() << 32)); }
+    void bytes(void *p, size_t n) {
+        if (pos + n > len) { overrun = true; return; }
+        memcpy(p, &buf[pos], n);
+        pos += n;
+    }
+
+    const uint8_t *buf;
+    size_t len;
+    size_t pos = 0;
+    bool overrun = false;
+};
+
+size_t snapshot_encode(const DisplayModel &model, const SnapshotSources &sources, uint8_t *buf) {
+    SnapshotWriter w(buf);
+    w.len = SNAPSHOT_HEADER; // Filled in once the payload is known
+
+    w.u32(sources.matches);
+    w.u32(sources.events);
+
+    int count = model.matchesCompleted < 0 ? 0 : model.matchesCompleted > 12 ? 12 : model.matchesCompleted;
+    w.u8(count);
+    for (int i = 0; i < count; i++) {
+        const GameScore &g = model.matchHistory[i];
+        w.i16(g.matchNum);
+        w.i16(g.autoFuel);
+        w.i16(g.autoClimb);
+        w.i16(g.teleFuel);
+        w.i16(g.teleClimb);
+        w.i16(g.foulPointsAwarded);
+        w.i16(g.totalScore);
+        w.u8((g.fuelRP ? 1 : 0) | (g.towerRP ? 2 : 0) | (g.type == 'P' ? 4 : 0));
+    }
+
+    for (const MatchEntry &m : model.schedule) {
+        w.u8(m.type);
+        w.i16(m.number);
+        w.u16(m.color);
+        w.i64(m.estTime);
+    }
+
+    w.i16(model.currentlyPlaying);
+
+    size_t nameLen = strnlen(model.nextEventName, sizeof(model.nextEventName) - 1);
+    w.u8(nameLen);
+    w.bytes(model.nextEventName, nameLen);
+    w.i64(model.nextEventDate);
+    w.i64(model.nextEventEnd);
+
+    size_t payload = w.len - SNAPSHOT_HEADER;
+    SnapshotWriter h(buf);
+    h.u32(SNAPSHOT_MAGIC);
+    h.u16(SNAPSHOT_VERSION);
+    h.u16(payload);
+    h.u32(esp_rom_crc32_le(0, &buf[SNAPSHOT_HEADER], payload));
+    return w.len;
+}
+
+bool snapshot_decode(const uint8_t *buf, size_t len, DisplayModel &model, SnapshotSources &sources) {
+    SnapshotReader h(buf, len);
+    if (h.u32() != SNAPSHOT_MAGIC || h.u16() != SNAPSHOT_VERSION) return false;
+    size_t payload = h.u16();
+    uint32_t crc = h.u32();
+    if (h.overrun || SNAPSHOT_HEADER + payload != len) return false;
+    if (esp_rom_crc32_le(0, &buf[SNAPSHOT_HEADER], payload) != crc) return false;
+
+    // Into a copy, so a file that passes the CRC but doesn't parse still leaves the model alone
+    DisplayModel m = model;
+    SnapshotReader r(&buf[SNAPSHOT_HEADER], payload);
+
+    SnapshotSources from;
+    from.matches = r.u32();
+    from.events = r.u32();
+
+    int count = r.u8();
+    if (count > 12) return false;
+    m.matchesCompleted = count;
+    for (int i = 0; i < count; i++) {
+        GameScore &g = m.matchHistory[i];
+        g.matchNum = r.i16();
+        g.autoFuel = r.i16();
+        g.autoClimb = r.i16();
+        g.teleFuel = r.i16();
+        g.teleClimb = r.i16();
+        g.foulPointsAwarded = r.i16();
+        g.totalScore = r.i16();
+        uint8_t flags = r.u8();
+        g.fuelRP = flags & 1;
+        g.towerRP = flags & 2;
+        g.type = (flags & 4) ? 'P' : 'Q';
+    }
+
+    for (MatchEntry &e : m.schedule) {
+        e.type = r.u8();
+        e.number = r.i16();
+        e.color = r.u16();
+        e.estTime = r.i64();
+    }
+
+    m.currentlyPlaying = r.i16();
+
+    size_t nameLen = r.u8();
+    if (nameLen >= sizeof(m.nextEventName)) return false;
+    r.bytes(m.nextEventName, nameLen);
+    m.nextEventName[nameLen] = 0;
+    m.nextEventDate = r.i64();
+    m.nextEventEnd = r.i64();
+
+    if (r.overrun || r.pos != payload) return false;
+    m.version = model.version;
+    model = m;
+    sources = from;
+    return true;
+}
+
+// --- Storage ---
+static bool mount() {
+    if (mounted) return true;
+
+    esp_vfs_spiffs_conf_t conf = {};
+    conf.base_path = SNAPSHOT_MOUNT;
+    conf.partition_label = SNAPSHOT_PARTITION;
+    conf.max_files = 2;
+    conf.format_if_mount_failed = true; // Never been used, so the first boot formats it (a few seconds, once)
+
+    esp_err_t err = esp_vfs_spiffs_register(&conf);
+    if (err != ESP_OK) {
+        printf("SNAPSHOT: Couldn't mount %s (%s)\n", SNAPSHOT_PARTITION, esp_err_to_name(err));
+        return false;
+    }
+    mounted = true;
+    return true;
+}
+
+static size_t readFile(const char *path, uint8_t *buf) {
+    FILE *f = fopen(path, "rb");
+    if (!f) return 0;
+    size_t len = fread(buf, 1, SNAPSHOT_MAX, f);
+    fclose(f);
+    return len;
+}
+
+bool snapshot_load(DisplayModel &model, SnapshotSources &sources) {
+    int64_t start = esp_timer_get_time();
+    if (!mount()) return false;
+
+    // The temporary file only survives if power went between removing the old snapshot and the rename
+    uint8_t buf[SNAPSHOT_MAX];
+    const char *path = SNAPSHOT_PATH;
+    size_t len = readFile(path, buf);
+    if (len == 0) {
+        path = SNAPSHOT_TEMP;
+        len = readFile(path, buf);
+    }
+    if (len == 0) {
+        printf("SNAPSHOT: None saved yet\n");
+        return false;
+    }
+    if (!snapshot_decode(buf, len, model, sources)) {
+        printf("SNAPSHOT: %s is from another version or damaged, ignoring it\n", path);
+        return false;
+    }
+
+    memcpy(lastSaved, buf, len);
+    lastSavedLen = len;
+    printf("SNAPSHOT: Restored %u bytes (%d matches, next event %s) in %lu ms\n", (unsigned)len,
+           model.matchesCompleted, model.nextEventName, (unsigned long)((esp_timer_get_time() - start) / 1000));
+    return true;
+}
+
+void snapshot_save(const DisplayModel &model, const SnapshotSources &sources) {
+    if (!mount()) return;
+
+    uint8_t buf[SNAPSHOT_MAX];
+    size_t len = snapshot_encode(model, sources, buf);
+    if (len == lastSavedLen && memcmp(buf, lastSaved, len) == 0) return;
+
+    FILE *f = fopen(SNAPSHOT_TEMP, "wb");
+    if (!f) {
+        printf("SNAPSHOT: Couldn't create %s\n", SNAPSHOT_TEMP);
+        return;
+    }
+    bool ok = fwrite(buf, 1, len, f) == len;
+    ok = (fclose(f) == 0) && ok;
+    if (!ok) {
+        printf("SNAPSHOT: Write failed\n");
+        return;
+    }
+
+    // SPIFFS won't rename over an existing file
+    remove(SNAPSHOT_PATH);
+    if (rename(SNAPSHOT_TEMP, SNAPSHOT_PATH) != 0) {
+        printf("SNAPSHOT: Rename failed\n");
+        return;
+    }
+
+    memcpy(lastSaved, buf, len);
+    lastSavedLen = len;
+    printf("SNAPSHOT: Saved %u bytes\n", (unsigned)len);
+}
@@ -0,0 +1,49 @@
+#ifndef MODEL_SNAPSHOT_H
+#define MODEL_SNAPSHOT_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "display_model.h"
+
+// --- Snapshot File ---
+// The last TBA data we had, kept in the storage partition so a reboot comes straight back up showing it
+#define SNAPSHOT_PARTITION "storage"
+#define SNAPSHOT_MOUNT     "/storage"
+#define SNAPSHOT_PATH      SNAPSHOT_MOUNT "/model.bin"
+
+#define SNAPSHOT_MAGIC   0x53414254 // "TBAS"
+#define SNAPSHOT_VERSION 4          // Bump whenever the encoding below changes, old files are then ignored
+#define SNAPSHOT_MAX     320        // Largest encoded model, header included
+
+// Fixed width little endian fields, not the structs as they sit in memory, so padding or a compiler
+// change can't silently misread an old file:
+//
+//   header   magic u32, version u16, payload length u16, payload CRC-32 u32
+//   sources  matches u32, events u32
+//   history  count u8, then per match: number, auto fuel, auto climb, tele fuel, tele climb, fouls,
+//            total (i16 each), RP flags u8
+//   schedule 3 x (type u8, number i16, color u16, estimated time i64)
+//   playing  i16
+//   event    name length u8, name, date i64
+
+// Which TBA responses the model was made from (HttpCacheEntry::validatorsHash(), 0 for none), so after a
+// reboot each part is only trusted while the validators that would get a 304 still describe it
+struct SnapshotSources {
+    uint32_t matches;
+    uint32_t events;
+};
+
+// Encode into buf (SNAPSHOT_MAX bytes), returning the length
+size_t snapshot_encode(const DisplayModel &model, const SnapshotSources &sources, uint8_t *buf);
+
+// Decode into model and sources, false (both untouched) if it's the wrong version, truncated or corrupt
+bool snapshot_decode(const uint8_t *buf, size_t len, DisplayModel &model, SnapshotSources &sources);
+
+// Mount the storage partition and read the snapshot, false if there isn't a usable one
+bool snapshot_load(DisplayModel &model, SnapshotSources &sources);
+
+// Write the snapshot if it differs from what's in flash already. Written to a temporary file first and
+// renamed over the old one, so losing power part way leaves the previous snapshot intact.
+void snapshot_save(const DisplayModel &model, const SnapshotSources &sources);
+
+#endif // MODEL_SNAPSHOT_H
@@ -1,34 +1,29 @@
 #include "pacman_engine.h"
 #include "globals.h"
 #include "pacman_sprites.h"
-#include <math.h>
-#include <cmath>
+#include "border_path.h"
 #include <cstdlib> // for abs
 
-// Helper functions (formerly in main.cpp)
+// Sprite centres run this far in, so the 7px sprites fill the 7px border
+#define PAC_INSET 3
 
-static void getPos(float p, int &x, int &y) {
-    const int perimeter = 612;
-    // Ensure p is always positive and within bounds
-    float safeP = fmod(p, (float)perimeter);
-    if (safeP < 0) safeP += perimeter;
+static BorderPath path;
 
-    if (safeP < 249) { x = 3 + safeP; y = 3; }                // Top
-    else if (safeP < 306) { x = 252; y = 3 + (safeP - 249); } // Right
-    else if (safeP < 555) { x = 252 - (safeP - 306); y = 60; }// Bottom
-    else { x = 3; y = 60 - (safeP - 555); }                   // Left
+void init_pacman_engine(int width, int height) {
+    path.build(width, height, PAC_INSET);
 }
 
-static void drawPac(GFXcanvas16 *canvas, int x, int y, float p, float currentSpeed) {
-    int dir;
-    bool movingForward = (currentSpeed > 0);
+// Helper functions (formerly in main.cpp)
+
+// Way a character faces at a point on the path
+static int facing(const PathPoint &pt, bool movingForward) {
+    return movingForward ? pt.dir : (pt.dir + 2) & 3;
+}
 
-    // Explicitly define the rails to prevent "lap-over" errors
-    if (p >= 0.0f && p < 249.0f)      dir = movingForward ? 0 : 2; // Top
-    else if (p >= 249.0f && p < 306.0f) dir = movingForward ? 1 : 3; // Right
-    else if (p >= 306.0f && p < 555.0f) dir = movingForward ? 2 : 0; // Bottom
-    else if (p >= 555.0f && p < 612.0f) dir = movingForward ? 3 : 1; // Left
-    else dir = movingForward ? 0 : 2; // Fallback to Top/Right
+static void drawPac(GFXcanvas16 *canvas, int p, int32_t currentSpeed) {
+    const PathPoint &pt = path.at(p);
+    int x = pt.x - PAC_INSET, y = pt.y - PAC_INSET;
+    int dir = facing(pt, currentSpeed > 0);
 
     // Toggle mouth
     bool open = ((int)(p / 5) % 2 == 0);
@@ -59,8 +54,10 @@ static void drawPac(GFXcanvas16 *canvas, int x, int y, float p, float currentSpe
     }
 }
 
-static void drawGhost(GFXcanvas16 *canvas, int x, int y, uint16_t color, bool scared, float p, float speed, GhostState state) {
+static void drawGhost(GFXcanvas16 *canvas, uint16_t color, bool scared, int p, int32_t speed, GhostState state) {
     if (state == GHOST_DEAD) return;
+    const PathPoint &pt = path.at(p);
+    int x = pt.x - PAC_INSET, y = pt.y - PAC_INSET;
 
     // Decide if drawing Eyes only
     if (state == GHOST_EYES) {
@@ -74,13 +71,8 @@ static void drawGhost(GFXcanvas16 *canvas, int x, int y, uint16_t color, bool sc
         return;
     }
 
-    bool movingForward = (speed > 0);
     // Determine direction same as Pac-Man
-    int dir;
-    if (p >= 0.0f && p < 249.0f)      dir = movingForward ? 0 : 2;
-    else if (p >= 249.0f && p < 306.0f) dir = movingForward ? 1 : 3;
-    else if (p >= 306.0f && p < 555.0f) dir = movingForward ? 2 : 0;
-    else                               dir = movingForward ? 3 : 1;
+    int dir = facing(pt, speed > 0);
 
     for (int i = 0; i < 7; i++) {
         for (int j = 0; j < 7; j++) {
@@ -100,42 +92,40 @@ static void drawGhost(GFXcanvas16 *canvas, int x, int y, uint16_t color, bool sc
     }
 }
 
-static void update_pacman_border(GFXcanvas16 *canvas, float &pPos, float gPosArr[4], bool &pMode, float speed, GhostState gState[4]) {
+static void update_pacman_border(GFXcanvas16 *canvas, Motion &pPos, Motion gPosArr[4], bool &pMode, int32_t speed, GhostState gState[4], uint32_t dtMs) {
     uint16_t ghostCols[4] = {GHOST_BLINKY, GHOST_PINKY, GHOST_INKY, GHOST_CLYDE};
-    // Note: We use 616.0f directly in fmod below, so perimeter variable isn't strictly needed here
+    int32_t perimeter = ANIM_FIX(path.length());
     bool movingForward = (speed > 0);
 
     // Update Pac-Man only if not won yet
     if (winStartTime == 0) {
-        pPos = fmod(pPos + speed, 616.0f);
-        if (pPos < 0) pPos += 616.0f;
+        pPos.advance(speed, dtMs);
+        pPos.wrap(perimeter);
     }
 
-    int pax, pay; getPos(pPos, pax, pay);
-    drawPac(canvas, pax - 3, pay - 3, pPos, speed);
+    drawPac(canvas, pPos.pixel(), speed);
 
     // Update Ghosts
     for (int i = 0; i < 4; i++) {
         if (gState[i] == GHOST_DEAD) continue;
 
         if (gState[i] == GHOST_ALIVE) {
-            float gSpeed = pMode ? 0.8f : 1.6f;
-            gPosArr[i] = fmod(gPosArr[i] + (movingForward ? gSpeed : -gSpeed), 616.0f);
-            if (gPosArr[i] < 0) gPosArr[i] += 616.0f;
+            int32_t gSpeed = pMode ? GHOST_SCARED_SPEED : GHOST_SPEED;
+            gPosArr[i].advance(movingForward ? gSpeed : -gSpeed, dtMs);
+            gPosArr[i].wrap(perimeter);
         }
         else if (gState[i] == GHOST_EYES) {
             // Move fast towards 0
             // Assuming "backward" means towards 0 via decrement
-            gPosArr[i] -= 6.0f;
-            if (gPosArr[i] <= 0) {
-                gPosArr[i] = 0;
+            gPosArr[i].advance(-EYES_SPEED, dtMs);
+            if (gPosArr[i].fix() <= 0) {
+                gPosArr[i].set(0);
                 gState[i] = GHOST_DEAD;
                 continue;
             }
         }
 
-        int gx, gy; getPos(gPosArr[i], gx, gy);
-        drawGhost(canvas, gx - 3, gy - 3, ghostCols[i], pMode, gPosArr[i], speed, gState[i]);
+        drawGhost(canvas, ghostCols[i], pMode, gPosArr[i].pixel(), speed, gState[i]);
     }
 }
 
@@ -143,14 +133,14 @@ void reset_pacman_game(uint32_t nowMs) {
     borderActive = true;
     lastBorderStartTime = nowMs;
     winStartTime = 0;
-    pacPos = 0; // Start at Top-Left
+    pacPos.set(0); // Start at Top-Left
     for(int i=0; i<4; i++) {
-        ghostPos[i] = 100 + (i * 20); // Reset ghosts
+        ghostPos[i].set(ANIM_FIX(100 + (i * 20))); // Reset ghosts
         ghostState[i] = GHOST_ALIVE;
     }
 }
 
-void run_pacman_cycle(GFXcanvas16 *canvas, uint32_t nowMs) {
+void run_pacman_cycle(GFXcanvas16 *canvas, uint32_t nowMs, uint32_t dtMs) {
 
     // WIN SEQUENCE
     if (winStartTime != 0) {
@@ -161,13 +151,12 @@ void run_pacman_cycle(GFXcanvas16 *canvas, uint32_t nowMs) {
             winStartTime = 0;
         } else {
             // Win Pulse (White/Black)
-            float p = (nowMs % 500) / 500.0f; // 0.5s cycle
-            uint16_t wColor = (p < 0.5f) ? 0xFFFF : 0x0000;
-            canvas->drawRect(0, 0, 256, 64, wColor);
-            canvas->drawRect(1, 1, 254, 62, wColor);
+            uint16_t wColor = (nowMs % 500 < 250) ? 0xFFFF : 0x0000; // 0.5s cycle
+            canvas->drawRect(0, 0, canvas->width(), canvas->height(), wColor);
+            canvas->drawRect(1, 1, canvas->width() - 2, canvas->height() - 2, wColor);
 
             // Draw static characters
-            update_pacman_border(canvas, pacPos, ghostPos, powerMode, worldSpeed, ghostState);
+            update_pacman_border(canvas, pacPos, ghostPos, powerMode, worldSpeed, ghostState, dtMs);
         }
         return; // Skip normal update
     }
@@ -177,9 +166,8 @@ void run_pacman_cycle(GFXcanvas16 *canvas, uint32_t nowMs) {
         if (ghostState[i] != GHOST_ALIVE) continue;
 
         // Check distance between Pac-Man and Ghost
-        float dist = std::abs(pacPos - ghostPos[i]);
-        // Handle the "wrap-around" distance at the 0/616 point
-        if (dist > 308) dist = 616 - dist;
+        // The shorter way round, across the 0 point if need be
+        int dist = path.distance(pacPos.pixel(), ghostPos[i].pixel());
 
         if (dist < 8) { // Collision!
             if (powerMode) {
@@ -203,19 +191,22 @@ void run_pacman_cycle(GFXcanvas16 *canvas, uint32_t nowMs) {
         winStartTime = nowMs; // Trigger Win Sequence
     }
 
-    // 2. POWER PELLET CORNERS (Same as before)
+    // 2. POWER PELLET CORNERS
     if (!powerMode) {
-        if (std::abs((int)pacPos - 0) < 5 || std::abs((int)pacPos - 250) < 5 ||
-            std::abs((int)pacPos - 308) < 5 || std::abs((int)pacPos - 558) < 5) {
-            powerMode = true;
-            powerStartTime = nowMs;
-            worldSpeed = 1.5f;
+        int p = pacPos.pixel();
+        for (int c = 0; c < 4; c++) {
+            if (std::abs(p - path.corner(c)) < 5) {
+                powerMode = true;
+                powerStartTime = nowMs;
+                worldSpeed = PAC_POWER_SPEED;
+                break;
+            }
         }
     } else if (nowMs - powerStartTime > 9000) {
         powerMode = false;
-        worldSpeed = 1.2f;
+        worldSpeed = PAC_SPEED;
     }
 
     // 3. DRAWING
-    update_pacman_border(canvas, pacPos, ghostPos, powerMode, worldSpeed, ghostState);
+    update_pacman_border(canvas, pacPos, ghostPos, powerMode, worldSpeed, ghostState, dtMs);
 }
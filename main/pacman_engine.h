@@ -4,8 +4,11 @@
 #include <stdint.h>
 #include "Adafruit_GFX.h"
 
-// Updates game state (collisions, etc.) and draws the frame
-void run_pacman_cycle(GFXcanvas16 *canvas, uint32_t nowMs);
+// Lays out the border path for a width x height display, once before the first game
+void init_pacman_engine(int width, int height);
+
+// Updates game state (collisions, etc.), moves everyone on by dtMs and draws the frame
+void run_pacman_cycle(GFXcanvas16 *canvas, uint32_t nowMs, uint32_t dtMs);
 
 // Resets game variables for a new run
 void reset_pacman_game(uint32_t nowMs);
@@ -0,0 +1,53 @@
+#include "poll_schedule.h"
+
+PollDecision nextPoll(const DisplayModel &model, time_t now, int failures, uint32_t random) {
+    // Failing: exponential backoff, with "full jitter" over the top half so a room full of boards
+    // that lost Wi-Fi together don't all come back at TBA on the same second
+    if (failures > 0) {
+        uint32_t backoff = POLL_RETRY_MS;
+        for (int i = 1; i < failures && backoff < POLL_RETRY_MAX_MS; i++) backoff *= 2;
+        if (backoff > POLL_RETRY_MAX_MS) backoff = POLL_RETRY_MAX_MS;
+        return { backoff / 2 + random % (backoff / 2 + 1), "retrying" };
+    }
+
+    if (now == 0) return { POLL_DEFAULT_MS, "clock not set" };
+
+    // Our matches: right on top of one, or how long until the next one starts to matter
+    bool haveMatches = false;
+    time_t untilWindow = -1;
+    for (int i = 0; i < 3; i++) {
+        const MatchEntry &m = model.schedule[i];
+        if (m.number <= 0) continue;
+
+        int ahead = m.number - model.currentlyPlaying;
+        if (model.currentlyPlaying > 0 && ahead >= 0 && ahead <= POLL_MATCH_QUEUE) {
+            return { POLL_MATCH_MS, "our match is up soon" };
+        }
+        if (m.estTime == 0) continue;
+
+        time_t start = m.estTime - POLL_MATCH_BEFORE_S;
+        time_t end = m.estTime + POLL_MATCH_AFTER_S;
+        if (now >= end) continue; // Over and scored
+        if (now >= start) return { POLL_MATCH_MS, "around our match" };
+
+        haveMatches = true;
+        if (untilWindow < 0 || start - now < untilWindow) untilWindow = start - now;
+    }
+
+    if (haveMatches) {
+        // Event day: steady polling, but wake up in time for the next match
+        uint32_t delay = POLL_EVENT_MS;
+        if (untilWindow < delay / 1000) delay = untilWindow * 1000;
+        if (delay < POLL_MATCH_MS) delay = POLL_MATCH_MS;
+        return { delay, "between our matches" };
+    }
+
+    // No matches ahead: nothing known at all, an event on (keep checking for its schedule), or back right off
+    // unless one is about to start
+    if (model.nextEventDate == 0) return { POLL_DEFAULT_MS, "no schedule yet" };
+    if (now >= model.nextEventDate && now < model.nextEventEnd + 24 * 60 * 60) {
+        return { POLL_EVENT_MS, "event on, none of our matches ahead" };
+    }
+    if (model.nextEventDate > now + 24 * 60 * 60) return { POLL_IDLE_MS, "no event today" };
+    return { POLL_DEFAULT_MS, "waiting for a schedule" };
+}
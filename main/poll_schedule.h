@@ -0,0 +1,31 @@
+#ifndef POLL_SCHEDULE_H
+#define POLL_SCHEDULE_H
+
+#include <stdint.h>
+#include <time.h>
+#include "display_model.h"
+
+// --- Poll Intervals ---
+#define POLL_MATCH_MS     20000    // Around one of our matches, while the score is due
+#define POLL_EVENT_MS     120000   // Event on, between our matches
+#define POLL_DEFAULT_MS   300000   // Nothing to go on (no schedule, clock not synced)
+#define POLL_IDLE_MS      3600000  // No event for a day or more
+#define POLL_RETRY_MS     10000    // First retry after a failure, doubling from there
+#define POLL_RETRY_MAX_MS 600000
+
+// How close to one of our matches counts as "around" it: from a little before the estimated start,
+// to long enough after for the match to run and the score to be posted
+#define POLL_MATCH_BEFORE_S (2 * 60)
+#define POLL_MATCH_AFTER_S  (15 * 60)
+#define POLL_MATCH_QUEUE    2 // Or when the field is this few matches away from ours
+
+struct PollDecision {
+    uint32_t delayMs;
+    const char *reason;
+};
+
+// When to poll TBA next, from what the schedule says and how the last polls went. now is 0 if the
+// clock isn't set yet. random is any random number, for spreading out retries.
+PollDecision nextPoll(const DisplayModel &model, time_t now, int failures, uint32_t random);
+
+#endif // POLL_SCHEDULE_H
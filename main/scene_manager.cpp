@@ -0,0 +1,105 @@
+#include "scene_manager.h"
+#include <stdio.h>
+#include "esp_timer.h"
+
+void SceneManager::addOverlay(Scene *s) {
+    overlays.push_back(s);
+    track(s);
+}
+
+void SceneManager::track(Scene *s) {
+    for (Scene *t : scenes) {
+        if (t == s) return;
+    }
+    scenes.push_back(s);
+}
+
+void SceneManager::setScene(Scene *s, uint32_t nowMs) {
+    if (active) active->exit();
+    active = s;
+    interrupted = nullptr;
+    track(s);
+    active->enter(nowMs);
+}
+
+void SceneManager::pushScene(Scene *s, uint32_t nowMs) {
+    // Leave the interrupted scene as it is, it picks up where it left off
+    if (active) active->exit();
+    interrupted = active;
+    active = s;
+    track(s);
+    active->enter(nowMs);
+}
+
+void SceneManager::run(Scene *s, uint32_t nowMs, uint32_t dtMs) {
+    int64_t start = esp_timer_get_time();
+    s->update(nowMs, dtMs);
+    s->render();
+    uint32_t us = (uint32_t)(esp_timer_get_time() - start);
+
+    s->totalUs += us;
+    s->frames++;
+    if (us > s->maxUs) s->maxUs = us;
+    if (us > s->budgetUs) s->overBudget++;
+}
+
+void SceneManager::frame(uint32_t nowMs) {
+    uint32_t dtMs = lastFrameMs ? nowMs - lastFrameMs : 0;
+    lastFrameMs = nowMs;
+
+    if (active && active->finished()) {
+        Scene *next = interrupted ? interrupted : home;
+        active->exit();
+        active = next;
+        interrupted = nullptr;
+        active->enter(nowMs);
+    }
+
+    if (active) run(active, nowMs, dtMs);
+
+    // Overlays come and go with the scene underneath
+    bool wanted = active && active->wantsOverlays();
+    if (wanted != overlaysOn) {
+        for (Scene *o : overlays) {
+            if (wanted) o->enter(nowMs);
+            else o->exit();
+        }
+        overlaysOn = wanted;
+    }
+
+    if (overlaysOn) {
+        for (Scene *o : overlays) run(o, nowMs, dtMs);
+    }
+
+    if (nowMs - reportStartMs >= SCENE_REPORT_MS) {
+        report();
+        reportStartMs = nowMs;
+    }
+}
+
+uint32_t SceneManager::msUntilChange(uint32_t nowMs) const {
+    // A scene that has just finished swaps for the next one on the coming frame
+    if (!active || active->finished()) return 0;
+
+    uint32_t ms = active->msUntilChange(nowMs);
+    if (overlaysOn) {
+        for (Scene *o : overlays) {
+            uint32_t m = o->msUntilChange(nowMs);
+            if (m < ms) ms = m;
+        }
+    }
+    return ms;
+}
+
+void SceneManager::report() {
+    for (Scene *s : scenes) {
+        if (s->frames == 0) continue;
+        printf("SCENE %s: %lu us avg, %lu us max, %lu/%lu frames over %lu us budget\n", s->name,
+               (unsigned long)(s->totalUs / s->frames), (unsigned long)s->maxUs,
+               (unsigned long)s->overBudget, (unsigned long)s->frames, (unsigned long)s->budgetUs);
+        s->totalUs = 0;
+        s->maxUs = 0;
+        s->frames = 0;
+        s->overBudget = 0;
+    }
+}
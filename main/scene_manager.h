@@ -0,0 +1,86 @@
+#ifndef SCENE_MANAGER_H
+#define SCENE_MANAGER_H
+
+#include <stdint.h>
+#include <vector>
+
+// Time between per-scene timing reports, however many frames the display drew in it
+#define SCENE_REPORT_MS 10000
+
+// One screen (or overlay) of the display. Scenes draw into their own display layers and mark what they
+// change dirty there, the compositor then works out what actually needs recompositing.
+class Scene {
+public:
+    Scene(const char *name, uint32_t budgetUs) : name(name), budgetUs(budgetUs) {}
+    virtual ~Scene() {}
+
+    // Becoming active / inactive - show or hide layers, reset animations
+    virtual void enter(uint32_t nowMs) {}
+    virtual void exit() {}
+
+    // Advance the animation / state machine, dtMs since the previous frame
+    virtual void update(uint32_t nowMs, uint32_t dtMs) = 0;
+
+    // Draw whatever changed into the scene's layers, marking it dirty
+    virtual void render() = 0;
+
+    // Main scenes: done, go back to what was on before
+    virtual bool finished() const { return false; }
+
+    // Main scenes: whether overlays (clock, border) run on top of this one
+    virtual bool wantsOverlays() const { return true; }
+
+    // How long until this scene next changes what's on screen by itself (new data and the button
+    // wake the display anyway). 0 while it's animating and wants every frame.
+    virtual uint32_t msUntilChange(uint32_t nowMs) const { return 0; }
+
+    const char *name;
+    uint32_t budgetUs; // Render time this scene should stay under per frame
+
+private:
+    friend class SceneManager;
+    uint64_t totalUs = 0;
+    uint32_t maxUs = 0;
+    uint32_t frames = 0;
+    uint32_t overBudget = 0;
+};
+
+// Runs one main scene plus any overlays on top of it. Only the active scene and the overlays are
+// updated and rendered, everything else costs nothing.
+class SceneManager {
+public:
+    // Where finished scenes go back to
+    void setHome(Scene *s) { home = s; track(s); }
+
+    void addOverlay(Scene *s);
+
+    // Replace the current scene
+    void setScene(Scene *s, uint32_t nowMs);
+
+    // Interrupt the current scene, it comes back once s has finished
+    void pushScene(Scene *s, uint32_t nowMs);
+
+    Scene *current() const { return active; }
+
+    // Update and render the active scene and overlays, timing each of them
+    void frame(uint32_t nowMs);
+
+    // Soonest msUntilChange() of the active scene and overlays
+    uint32_t msUntilChange(uint32_t nowMs) const;
+
+private:
+    void track(Scene *s);
+    void run(Scene *s, uint32_t nowMs, uint32_t dtMs);
+    void report();
+
+    Scene *home = nullptr;
+    Scene *active = nullptr;
+    Scene *interrupted = nullptr;
+    std::vector<Scene *> overlays;
+    std::vector<Scene *> scenes; // Everything that has run, for the report
+    bool overlaysOn = false;
+    uint32_t lastFrameMs = 0;
+    uint32_t reportStartMs = 0;
+};
+
+#endif // SCENE_MANAGER_H
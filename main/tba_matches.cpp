@@ -0,0 +1,76 @@
+#include "tba_matches.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Which of two unplayed matches comes first: by time where TBA has one, quals before playoffs otherwise
+static bool sooner(const MatchEntry &a, const MatchEntry &b) {
+    if (a.estTime && b.estTime && a.estTime != b.estTime) return a.estTime < b.estTime;
+    if (!a.estTime != !b.estTime) return a.estTime != 0;
+    if (a.type != b.type) return a.type == 'Q';
+    return a.number < b.number;
+}
+
+void MatchListener::onJson(const JsonStream &json, JsonEvent event, const char *value) {
+    if (json.depth() == 1 && event == JSON_OBJECT_START) {
+        matchNum = 0;
+        setNum = 0;
+        compLevel[0] = 0;
+        redScore = -1;
+        weAreRed = false;
+        weAreBlue = false;
+        scheduledTime = 0;
+        predictedTime = 0;
+    }
+    else if (json.depth() == 2 && event == JSON_NUMBER) {
+        if (strcmp(json.key(), "match_number") == 0) matchNum = atoi(value);
+        else if (strcmp(json.key(), "set_number") == 0) setNum = atoi(value);
+        else if (strcmp(json.key(), "time") == 0) scheduledTime = (time_t)atoll(value);
+        else if (strcmp(json.key(), "predicted_time") == 0) predictedTime = (time_t)atoll(value);
+    }
+    else if (json.depth() == 2 && event == JSON_STRING && strcmp(json.key(), "comp_level") == 0) {
+        snprintf(compLevel, sizeof(compLevel), "%s", value);
+    }
+    else if (json.depth() == 4 && event == JSON_NUMBER && strcmp(json.key(), "score") == 0 &&
+             strcmp(json.key(3), "red") == 0 && strcmp(json.key(2), "alliances") == 0) {
+        redScore = atoi(value);
+    }
+    else if (json.depth() == 5 && event == JSON_STRING && strcmp(json.key(4), "team_keys") == 0 &&
+             strcmp(json.key(2), "alliances") == 0 && strcmp(value, TBA_TEAM_KEY) == 0) {
+        if (strcmp(json.key(3), "red") == 0) weAreRed = true;
+        else if (strcmp(json.key(3), "blue") == 0) weAreBlue = true;
+    }
+    else if (json.depth() == 1 && event == JSON_OBJECT_END) {
+        bool qual = compLevel[0] == 0 || strcmp(compLevel, "qm") == 0;
+        char type = qual ? 'Q' : 'P';
+        int number = (qual || strcmp(compLevel, "f") == 0) ? matchNum : setNum;
+        // A score of -1 is TBA's unplayed
+        if (redScore >= 0) played(type, number);
+        else upcoming(type, number);
+    }
+}
+
+void MatchListener::played(char type, int number) {
+    if (type == 'Q' && number > currentlyPlaying) currentlyPlaying = number;
+    if (completed >= 12) return;
+
+    GameScore &score = history[completed++];
+    score.type = type;
+    score.matchNum = number;
+    score.totalScore = redScore;
+    // For the 2026 schema, we'll fill these with 0 for now
+    score.autoFuel = 0;
+    score.teleFuel = 0;
+}
+
+void MatchListener::upcoming(char type, int number) {
+    if (number <= 0 || (!weAreRed && !weAreBlue)) return;
+    MatchEntry entry = { type, number, (uint16_t)(weAreRed ? 0xF800 : 0x001F), predictedTime ? predictedTime : scheduledTime };
+
+    // In order, the latest dropping off the end
+    int at = 0;
+    while (at < 3 && schedule[at].number != 0 && sooner(schedule[at], entry)) at++;
+    if (at == 3) return;
+    for (int j = 2; j > at; j--) schedule[j] = schedule[j - 1];
+    schedule[at] = entry;
+}
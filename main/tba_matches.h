@@ -0,0 +1,40 @@
+#ifndef TBA_MATCHES_H
+#define TBA_MATCHES_H
+
+#include "display_model.h"
+#include "json_stream.h"
+
+// Whose matches TBA_URL lists (the same team as WEBHOOK_TEAM_KEY), to tell which alliance we're on
+#define TBA_TEAM_KEY "frc5459"
+
+// --- Matches: [{"comp_level": "qm", "set_number": s, "match_number": n, "alliances": {"red": {"score": s, "team_keys": [...]}, ...},
+//               "time": t, "predicted_time": t, ...}, ...] ---
+// Numbered like the webhook: playoffs by their set, finals by match.
+//
+// The played ones (the first 12) go to the history. The unplayed ones are our schedule: the three soonest, in our
+// alliance's colour, at TBA's predicted time (or the scheduled one before there's a prediction). Our team's matches
+// don't say where the field is, only that it's got past the last of ours played, so that's currentlyPlaying.
+class MatchListener : public JsonListener {
+public:
+    GameScore history[12] = {};
+    int completed = 0;
+    MatchEntry schedule[3] = {};
+    int currentlyPlaying = 0;
+
+    void onJson(const JsonStream &json, JsonEvent event, const char *value) override;
+
+private:
+    int matchNum = 0;
+    int setNum = 0;
+    char compLevel[4] = "";
+    int redScore = -1;
+    bool weAreRed = false;
+    bool weAreBlue = false;
+    time_t scheduledTime = 0;
+    time_t predictedTime = 0;
+
+    void played(char type, int number);
+    void upcoming(char type, int number);
+};
+
+#endif // TBA_MATCHES_H
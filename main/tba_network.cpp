@@ -1,40 +1,153 @@
 #include "tba_network.h"
 #include "config.h"
 #include "globals.h"
-#include "cJSON.h"
+#include "matrix_display.h"
+#include "json_stream.h"
+#include "http_cache.h"
+#include "gzip_stream.h"
+#include "poll_schedule.h"
+#include "model_snapshot.h"
+#include "tba_webhook.h"
+#include "tba_matches.h"
+#include "boot_log.h"
 #include "esp_http_client.h"
 #include "esp_crt_bundle.h"
 #include "esp_wifi.h"
 #include "esp_log.h"
+#include "esp_timer.h"
+#include "esp_random.h"
+#include "esp_heap_caps.h"
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
+#include "freertos/queue.h"
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
+#include <strings.h>
 #include <time.h>
 
-struct ResponseData {
-    char* data;
-    int len;
-    int capacity;
+// --- Requests ---
+// Everything goes through one client in async mode, a step at a time: each esp_http_client_perform()
+// does what it can in TBA_STEP_MS and comes back, so a stalled connection only holds up its own request.
+// Between steps the task applies pushed updates and checks the request's deadline, and a request can be
+// cancelled at any point.
+#define TBA_STEP_MS     50    // Longest a step blocks for
+#define TBA_DEADLINE_MS 20000 // Default for a whole request from when it starts, retry included
+
+enum TbaResult {
+    TBA_FRESH,        // New data, parsed
+    TBA_NOT_MODIFIED, // Same as last time, nothing to do
+    TBA_FAILED
 };
 
+enum TbaRequestState {
+    TBA_QUEUED,
+    TBA_RUNNING,
+    TBA_DONE
+};
+
+// One GET, from queued to done
+struct TbaRequest {
+    HttpCacheEntry *cache;
+    JsonStream *json;
+    uint32_t deadlineMs;
+    TbaRequestState state;
+    TbaResult result;
+    bool cancelled;  // Set to drop it, queued or running
+    bool retried;
+
+    // Filled in by the event handler
+    uint32_t parseUs;
+    bool connected;  // Had to (re)connect for this one
+    bool gzipped;    // Content-Encoding: gzip, so it goes through the inflater first
+    uint32_t airBytes;
+
+    // esp_timer times, for the latency breakdown
+    int64_t queuedUs;
+    int64_t startUs;
+    int64_t connectedUs;
+    int64_t firstByteUs;
+};
+
+// Only one request runs at a time, so one inflater does for all of them
+static GzipStream gzip;
+
+// --- Connection ---
+// One client for everything on TBA, kept for good. Keep-alive carries the connection from one request
+// to the next, and when TBA has dropped it while we slept the saved TLS session makes the reconnect an
+// abbreviated handshake rather than a full one through the certificate bundle.
+//
+// The client's receive buffer is the only response memory there is: allocated with the client, reused for
+// every request after, and handed to the parser a piece at a time. It's sized so a TLS record comes
+// through in a few pieces instead of the default 512 byte ones.
+#define TBA_RX_BUFFER 2048
+static esp_http_client_handle_t tbaClient = NULL;
+static bool tbaClientConnected = false; // It's been connected before, so it has a session to offer
+
+struct TbaLinkStats {
+    uint32_t handshakes;
+    uint64_t handshakeUs;
+    uint32_t maxHandshakeUs;
+    uint32_t resumes;     // Handshakes offering the session from the last one
+    uint64_t resumeUs;
+    uint32_t requests;
+    uint64_t latencyUs;
+    uint32_t maxLatencyUs;
+    uint32_t pieces;      // ON_DATA callbacks
+    uint32_t maxPiece;    // High water marks of what went through the receive buffer
+    uint32_t maxBodyBytes;
+    uint64_t airBytes;  // 200 bodies as received...
+    uint64_t jsonBytes; // ...and as parsed, the same unless they came gzipped
+    uint64_t inflateUs;
+    uint64_t parseUs;
+    uint64_t firstByteUs;
+    uint32_t timedOut;
+    uint32_t cancelled;
+};
+static TbaLinkStats linkStats = {};
+
+// The JSON goes straight from the HTTP client into a JsonStream, nothing keeps the whole response
 static esp_err_t _http_event_handler(esp_http_client_event_t *evt) {
-    if (evt->event_id == HTTP_EVENT_ON_DATA) {
-        ResponseData* buf = (ResponseData*)evt->user_data;
-        if (buf) {
-            if (buf->len + evt->data_len + 1 > buf->capacity) {
-                int new_cap = buf->capacity + evt->data_len + 1024;
-                char* new_data = (char*)realloc(buf->data, new_cap);
-                if (new_data) {
-                    buf->data = new_data;
-                    buf->capacity = new_cap;
-                } else {
-                    return ESP_FAIL; // OOM
-                }
+    TbaRequest* fetch = (TbaRequest*)evt->user_data;
+    if (!fetch) return ESP_OK;
+
+    if (evt->event_id == HTTP_EVENT_ON_CONNECTED) {
+        // TCP and TLS are both done by now
+        fetch->connectedUs = esp_timer_get_time();
+        uint32_t us = (uint32_t)(fetch->connectedUs - fetch->startUs);
+        fetch->connected = true;
+        linkStats.handshakes++;
+        linkStats.handshakeUs += us;
+        if (us > linkStats.maxHandshakeUs) linkStats.maxHandshakeUs = us;
+        if (tbaClientConnected) {
+            linkStats.resumes++;
+            linkStats.resumeUs += us;
+        }
+        tbaClientConnected = true;
+    }
+    else if (evt->event_id == HTTP_EVENT_ON_HEADER) {
+        if (!fetch->firstByteUs) fetch->firstByteUs = esp_timer_get_time();
+        fetch->cache->onHeader(evt->header_key, evt->header_value);
+        if (strcasecmp(evt->header_key, "Content-Encoding") == 0 && strcasecmp(evt->header_value, "gzip") == 0) {
+            fetch->gzipped = true;
+            gzip.begin();
+        }
+    }
+    else if (evt->event_id == HTTP_EVENT_ON_DATA) {
+        // Error pages aren't what the listeners are looking for
+        linkStats.pieces++;
+        if ((uint32_t)evt->data_len > linkStats.maxPiece) linkStats.maxPiece = evt->data_len;
+        if (esp_http_client_get_status_code(evt->client) == 200) {
+            int64_t start = esp_timer_get_time();
+            fetch->airBytes += evt->data_len;
+            if (fetch->gzipped) {
+                uint32_t inflateUs = gzip.inflateUs;
+                gzip.feed((const char*)evt->data, evt->data_len, *fetch->json);
+                fetch->parseUs -= gzip.inflateUs - inflateUs; // Just the parser's share
+            } else {
+                fetch->json->feed((const char*)evt->data, evt->data_len);
             }
-            memcpy(buf->data + buf->len, evt->data, evt->data_len);
-            buf->len += evt->data_len;
-            buf->data[buf->len] = 0; // Null terminate
+            fetch->parseUs += (uint32_t)(esp_timer_get_time() - start);
         }
     }
     return ESP_OK;
@@ -52,150 +165,387 @@ static time_t parse_date(const char* date_str) {
     return 0;
 }
 
-static void parse_tba_events(const char *json_string) {
-    printf("TBA DEBUG: Parsing Events JSON...\n");
-    cJSON *root = cJSON_Parse(json_string);
-    if (root == NULL) {
-        printf("TBA DEBUG: JSON Parse Failed\n");
-        return;
-    }
-
-    int event_count = cJSON_GetArraySize(root);
-    printf("TBA DEBUG: Found %d events\n", event_count);
-
-    time_t now;
-    time(&now);
-    time_t min_diff = -1;
-
-    for (int i = 0; i < event_count; i++) {
-        cJSON *evt = cJSON_GetArrayItem(root, i);
-        cJSON *date_item = cJSON_GetObjectItem(evt, "start_date");
-        cJSON *city_item = cJSON_GetObjectItem(evt, "city");
-
-        if (date_item && city_item) {
-            time_t evt_time = parse_date(date_item->valuestring);
-            printf("TBA DEBUG: Event %d Date: %s Parsed: %ld Now: %ld\n", i, date_item->valuestring, (long)evt_time, (long)now);
-
-            if (evt_time > now) {
-                double diff = difftime(evt_time, now);
-                if (min_diff == -1 || diff < min_diff) {
-                    min_diff = (time_t)diff;
-                    nextEventDate = evt_time;
-                    nextEventName = std::string(city_item->valuestring); // Use City name
-                    printf("TBA DEBUG: Selected Next Event: %s\n", nextEventName.c_str());
+// --- Events: [{"city": ..., "start_date": "YYYY-MM-DD", "end_date": "YYYY-MM-DD", ...}, ...] ---
+// Keeps the event that's on now, or else the soonest one still to come
+class EventListener : public JsonListener {
+public:
+    int eventCount = 0;
+    time_t nextDate = 0;
+    time_t nextEnd = 0;
+    char nextName[32] = "";
+
+    EventListener() { time(&now); }
+
+    void onJson(const JsonStream &json, JsonEvent event, const char *value) override {
+        if (json.depth() == 1 && event == JSON_OBJECT_START) {
+            date[0] = 0;
+            endDate[0] = 0;
+            city[0] = 0;
+        }
+        else if (json.depth() == 2 && event == JSON_STRING) {
+            if (strcmp(json.key(), "start_date") == 0) snprintf(date, sizeof(date), "%s", value);
+            else if (strcmp(json.key(), "end_date") == 0) snprintf(endDate, sizeof(endDate), "%s", value);
+            else if (strcmp(json.key(), "city") == 0) snprintf(city, sizeof(city), "%s", value);
+        }
+        else if (json.depth() == 1 && event == JSON_OBJECT_END) {
+            int i = eventCount++;
+            if (date[0] && city[0]) {
+                time_t evt_time = parse_date(date);
+                time_t evt_end = endDate[0] ? parse_date(endDate) : evt_time;
+                if (evt_end < evt_time) evt_end = evt_time;
+                printf("TBA DEBUG: Event %d Date: %s Parsed: %ld Now: %ld\n", i, date, (long)evt_time, (long)now);
+
+                // Still counts until its last day is over
+                if (evt_end + 24 * 60 * 60 > now && (nextDate == 0 || evt_time < nextDate)) {
+                    nextDate = evt_time;
+                    nextEnd = evt_end;
+                    // Use City name
+                    snprintf(nextName, sizeof(nextName), "%s", city);
+                    printf("TBA DEBUG: Selected Next Event: %s\n", nextName);
                 }
             }
         }
     }
-    cJSON_Delete(root);
-}
-
-static void parse_tba_json(const char *json_string) {
-    cJSON *root = cJSON_Parse(json_string);
-    if (root == NULL) return;
 
-    int match_count = cJSON_GetArraySize(root);
-    matchesCompleted = 0; // Reset history to fill with fresh API data
-
-    for (int i = 0; i < match_count && i < 12; i++) {
-        cJSON *match = cJSON_GetArrayItem(root, i);
-        cJSON *alliances = cJSON_GetObjectItem(match, "alliances");
-        if (!alliances) continue;
+private:
+    time_t now;
+    char date[16];
+    char endDate[16];
+    char city[32];
+};
 
-        cJSON *red = cJSON_GetObjectItem(alliances, "red");
-        // cJSON *blue = cJSON_GetObjectItem(alliances, "blue"); // Unused for now
+// The async client only does HTTPS, but a config.h from before it may still have an http:// TBA_URL.
+// Room for the 's' if it needs putting in.
+static char matchUrl[sizeof(TBA_URL) + 1] = TBA_URL;
+
+static HttpCacheEntry matchCache("matches", matchUrl);
+static HttpCacheEntry eventCache("events", "https://www.thebluealliance.com/api/v3/team/frc5459/events/2026/simple");
+
+static void tba_queue(TbaRequest &req, HttpCacheEntry &cache, JsonStream &json, uint32_t deadlineMs) {
+    req = {};
+    req.cache = &cache;
+    req.json = &json;
+    req.deadlineMs = deadlineMs;
+    req.state = TBA_QUEUED;
+    req.result = TBA_FAILED;
+    req.queuedUs = esp_timer_get_time();
+}
 
-        // We check if the score exists and is not -1 (unplayed)
-        cJSON *rScoreObj = cJSON_GetObjectItem(red, "score");
-        if (rScoreObj && rScoreObj->valueint >= 0) {
-            matchHistory[matchesCompleted].matchNum = cJSON_GetObjectItem(match, "match_number")->valueint;
-            matchHistory[matchesCompleted].totalScore = rScoreObj->valueint;
+// Wrap up a request, err being how the last step went
+static void tba_finish(TbaRequest &req, esp_err_t err) {
+    HttpCacheEntry &cache = *req.cache;
+    JsonStream &json = *req.json;
+    int status = (err == ESP_OK) ? esp_http_client_get_status_code(tbaClient) : 0; // Anything else is stale
+    int64_t endUs = esp_timer_get_time();
+
+    uint32_t latencyUs = (uint32_t)(endUs - req.startUs);
+    linkStats.requests++;
+    linkStats.latencyUs += latencyUs;
+    if (latencyUs > linkStats.maxLatencyUs) linkStats.maxLatencyUs = latencyUs;
+    if (req.firstByteUs) linkStats.firstByteUs += req.firstByteUs - req.startUs;
+    if (json.bytesFed() > linkStats.maxBodyBytes) linkStats.maxBodyBytes = json.bytesFed();
+    printf("TBA TASK: %s Fetch Status = %d in %lu ms (%s connection); queued %lu ms, first byte at %ld ms\n",
+           cache.name, status, (unsigned long)(latencyUs / 1000), req.connected ? "new" : "kept",
+           (unsigned long)((req.startUs - req.queuedUs) / 1000),
+           req.firstByteUs ? (long)((req.firstByteUs - req.startUs) / 1000) : -1L);
+
+    if (err != ESP_OK && tbaClient) {
+        // Whatever state the exchange was left in, start from scratch next time
+        esp_http_client_cleanup(tbaClient);
+        tbaClient = NULL;
+    }
 
-            // For the 2026 schema, we'll fill these with 0 for now
-            matchHistory[matchesCompleted].autoFuel = 0;
-            matchHistory[matchesCompleted].teleFuel = 0;
+    req.result = TBA_FAILED;
+    if (err == ESP_OK && status == 304) {
+        cache.notModified();
+        req.result = TBA_NOT_MODIFIED;
+    } else if (err == ESP_OK && status == 200 && json.finish() && (!req.gzipped || gzip.finish())) {
+        uint32_t inflateUs = req.gzipped ? gzip.inflateUs : 0;
+        linkStats.airBytes += req.airBytes;
+        linkStats.jsonBytes += json.bytesFed();
+        linkStats.inflateUs += inflateUs;
+        linkStats.parseUs += req.parseUs;
+        printf("TBA TASK: %s %lu bytes on air for %lu of JSON%s, %lu us inflating, %lu us parsing\n", cache.name,
+               (unsigned long)req.airBytes, (unsigned long)json.bytesFed(), req.gzipped ? " (gzip)" : "",
+               (unsigned long)inflateUs, (unsigned long)req.parseUs);
+
+        // A 304 saves what came over the air and all the work on it
+        cache.used(req.airBytes, req.parseUs + inflateUs);
+        req.result = TBA_FRESH;
+    }
+    cache.report();
+    req.state = TBA_DONE;
+}
 
-            matchesCompleted++;
+// GET the request's URL, asking for it only if it's changed since the copy we have
+static void tba_start(TbaRequest &req) {
+    HttpCacheEntry &cache = *req.cache;
+    req.state = TBA_RUNNING;
+    req.startUs = esp_timer_get_time();
+
+    if (!tbaClient) {
+        esp_http_client_config_t config = {};
+        config.url = cache.url;
+        config.crt_bundle_attach = esp_crt_bundle_attach;
+        config.is_async = true;
+        config.timeout_ms = TBA_STEP_MS; // In async mode, how long a step waits on the socket
+        config.event_handler = _http_event_handler;
+        config.buffer_size = TBA_RX_BUFFER;
+        config.keep_alive_enable = true;
+#ifdef CONFIG_ESP_TLS_CLIENT_SESSION_TICKETS
+        config.save_client_session = true;
+#endif
+        tbaClient = esp_http_client_init(&config);
+        tbaClientConnected = false;
+        if (!tbaClient) {
+            tba_finish(req, ESP_FAIL);
+            return;
         }
+        esp_http_client_set_header(tbaClient, "X-TBA-Auth-Key", TBA_KEY);
+        esp_http_client_set_header(tbaClient, "Accept-Encoding", "gzip"); // TBA's JSON shrinks to a fraction
+    } else {
+        esp_http_client_set_url(tbaClient, cache.url);
     }
-    cJSON_Delete(root);
+    esp_http_client_set_user_data(tbaClient, &req);
+    cache.begin(tbaClient);
 }
 
-void tba_api_task(void *pvParameters) {
-    printf("TBA TASK: Started and running on Core %d\n", xPortGetCoreID());
+// Move a running request on by one step
+static void tba_step(TbaRequest &req) {
+    uint32_t elapsedMs = (uint32_t)((esp_timer_get_time() - req.startUs) / 1000);
+    if (req.cancelled || elapsedMs >= req.deadlineMs) {
+        printf("TBA TASK: %s %s after %lu ms\n", req.cache->name, req.cancelled ? "cancelled" : "timed out",
+               (unsigned long)elapsedMs);
+        if (req.cancelled) linkStats.cancelled++;
+        else linkStats.timedOut++;
+        tba_finish(req, ESP_ERR_TIMEOUT);
+        return;
+    }
 
-    while (1) {
-        // Get the WiFi interface handle
-        esp_netif_ip_info_t ip_info;
-        esp_netif_t* netif = esp_netif_get_handle_from_ifkey("WIFI_STA_DEF");
+    esp_err_t err = esp_http_client_perform(tbaClient);
+    if (err == ESP_ERR_HTTP_EAGAIN) return;
+
+    if (err != ESP_OK && !req.connected && !req.retried) {
+        // Most likely TBA closed the kept connection, so once more on a new one
+        esp_http_client_close(tbaClient);
+        req.json->reset();
+        req.retried = true;
+        req.parseUs = 0;
+        req.gzipped = false;
+        req.airBytes = 0;
+        req.firstByteUs = 0;
+        return;
+    }
+    tba_finish(req, err);
+}
 
-        // Check if we actually have an IP address yet
-        if (netif && esp_netif_get_ip_info(netif, &ip_info) == ESP_OK && ip_info.ip.addr != 0) {
+static void tba_link_report() {
+    if (linkStats.requests == 0) return;
+    printf("TBA LINK: %lu requests, %lu ms avg / %lu ms max; %lu handshakes, %lu ms avg / %lu ms max\n",
+           (unsigned long)linkStats.requests, (unsigned long)(linkStats.latencyUs / linkStats.requests / 1000),
+           (unsigned long)(linkStats.maxLatencyUs / 1000), (unsigned long)linkStats.handshakes,
+           (unsigned long)(linkStats.handshakes ? linkStats.handshakeUs / linkStats.handshakes / 1000 : 0),
+           (unsigned long)(linkStats.maxHandshakeUs / 1000));
+#ifdef CONFIG_ESP_TLS_CLIENT_SESSION_TICKETS
+    // TBA can still turn a session down, but a resumed handshake skips the certificate chain, so while it's
+    // working the second average comes out well under the first
+    uint32_t full = linkStats.handshakes - linkStats.resumes;
+    printf("TBA LINK: %lu new sessions, %lu ms avg; %lu offering the saved one, %lu ms avg\n", (unsigned long)full,
+           (unsigned long)(full ? (linkStats.handshakeUs - linkStats.resumeUs) / full / 1000 : 0),
+           (unsigned long)linkStats.resumes,
+           (unsigned long)(linkStats.resumes ? linkStats.resumeUs / linkStats.resumes / 1000 : 0));
+#else
+    printf("TBA LINK: TLS session resumption is off (CONFIG_ESP_TLS_CLIENT_SESSION_TICKETS), every handshake is a full one\n");
+#endif
+    printf("TBA LINK: first byte %lu ms avg; %lu timed out, %lu cancelled\n",
+           (unsigned long)(linkStats.firstByteUs / linkStats.requests / 1000), (unsigned long)linkStats.timedOut,
+           (unsigned long)linkStats.cancelled);
+    // A steady DMA low water mark poll after poll is the heap not being chewed up by fetches
+    printf("TBA LINK: bodies up to %lu bytes; %lu pieces so far, up to %lu of %d; DMA heap low water %u bytes\n",
+           (unsigned long)linkStats.maxBodyBytes, (unsigned long)linkStats.pieces, (unsigned long)linkStats.maxPiece,
+           TBA_RX_BUFFER, (unsigned)heap_caps_get_minimum_free_size(MALLOC_CAP_DMA));
+    if (linkStats.jsonBytes > 0) {
+        printf("TBA LINK: %llu bytes on air for %llu of JSON (%llu%%), %llu ms inflating / %llu ms parsing; inflater %u bytes\n",
+               (unsigned long long)linkStats.airBytes, (unsigned long long)linkStats.jsonBytes,
+               (unsigned long long)(linkStats.airBytes * 100 / linkStats.jsonBytes),
+               (unsigned long long)(linkStats.inflateUs / 1000), (unsigned long long)(linkStats.parseUs / 1000),
+               (unsigned)GzipStream::memoryBytes());
+    }
+}
 
-            printf("TBA TASK: IP Found (%d.%d.%d.%d). Fetching TBA...\n",
-                    IP2STR(&ip_info.ip));
+// Which responses the snapshot restored at boot was made from, checked against the saved validators once
+// they're loaded
+static bool snapshotRestored = false;
+static SnapshotSources snapshotSources = {};
+
+bool tba_restore_snapshot() {
+    if (!snapshot_load(displayModel.edit(), snapshotSources)) return false;
+    displayModel.publish();
+    matrix_wake();
+    snapshotRestored = true;
+    return true;
+}
+
+// What's in the model now, for saving it
+static void tba_save_snapshot(const DisplayModel &model) {
+    snapshot_save(model, { matchCache.validatorsHash(), eventCache.validatorsHash() });
+}
 
-            esp_http_client_config_t config = {};
-            // Using HTTP for now to avoid SSL certificate issues
-            config.url = TBA_URL;
-            config.crt_bundle_attach = esp_crt_bundle_attach;
-            config.timeout_ms = 40000;
+// Pushed updates from the webhook server. Applied here rather than in the server's task, so the display
+// model keeps its one writer.
+static QueueHandle_t webhookQueue = NULL;
 
-            // 1. Fetch Match Data
-            ResponseData matchBuf = { (char*)malloc(1024), 0, 1024 };
-            if (matchBuf.data) matchBuf.data[0] = 0;
+// Sleep for ms, applying any pushed updates the moment they arrive
+static void tba_wait(uint32_t ms) {
+    TickType_t until = xTaskGetTickCount() + pdMS_TO_TICKS(ms);
+    WebhookUpdate update;
+    while (1) {
+        TickType_t left = until - xTaskGetTickCount();
+        if ((int32_t)left <= 0) left = 0;
+        if (xQueueReceive(webhookQueue, &update, left) != pdTRUE) return;
+
+        DisplayModel &model = displayModel.edit();
+        if (!webhook_apply(model, update)) continue;
+        displayModel.publish();
+        matrix_wake();
+        printf("WEBHOOK: %s %c%d applied %lu us after it came in\n",
+               update.kind == WEBHOOK_MATCH_SCORE ? "Score for" : "Upcoming", update.type, update.number,
+               (unsigned long)(esp_timer_get_time() - update.receivedUs));
+        tba_save_snapshot(model);
+    }
+}
 
-            config.event_handler = _http_event_handler;
-            config.user_data = &matchBuf;
+static bool tba_have_ip(esp_netif_ip_info_t &ip_info) {
+    esp_netif_t* netif = esp_netif_get_handle_from_ifkey("WIFI_STA_DEF");
+    return netif && esp_netif_get_ip_info(netif, &ip_info) == ESP_OK && ip_info.ip.addr != 0;
+}
 
-            esp_http_client_handle_t client = esp_http_client_init(&config);
-            esp_http_client_set_header(client, "X-TBA-Auth-Key", TBA_KEY);
+// Run queued requests in order until they're all done. Losing WiFi cancels whatever's left rather than
+// waiting out the deadlines.
+static void tba_run(TbaRequest *requests, int count) {
+    for (int i = 0; i < count; i++) {
+        TbaRequest &req = requests[i];
+        while (req.state != TBA_DONE) {
+            esp_netif_ip_info_t ip_info;
+            if (!req.cancelled && !tba_have_ip(ip_info)) {
+                printf("TBA TASK: Lost WiFi, cancelling %d requests\n", count - i);
+                for (int j = i; j < count; j++) requests[j].cancelled = true;
+            }
 
-            esp_err_t err = esp_http_client_perform(client);
-            if (err == ESP_OK && esp_http_client_get_status_code(client) == 200) {
-                parse_tba_json(matchBuf.data);
+            if (req.state == TBA_QUEUED && req.cancelled) {
+                linkStats.cancelled++;
+                req.state = TBA_DONE; // Never went near the network
+            } else if (req.state == TBA_QUEUED) {
+                tba_start(req);
             } else {
-                printf("TBA TASK: Match Fetch failed (Status %d)\n", esp_http_client_get_status_code(client));
+                tba_step(req);
             }
-            esp_http_client_cleanup(client);
-            if (matchBuf.data) free(matchBuf.data);
+            tba_wait(0); // Pushed updates don't wait for the fetch
+        }
+    }
+}
 
-            // Brief pause
-            vTaskDelay(pdMS_TO_TICKS(2000));
+// Make TBA_URL https://, or say clearly why nothing will ever arrive
+static void tba_check_url() {
+    if (strncmp(matchUrl, "https://", 8) == 0) return;
+    if (strncmp(matchUrl, "http://", 7) == 0) {
+        memmove(&matchUrl[5], &matchUrl[4], strlen(&matchUrl[4]) + 1);
+        matchUrl[4] = 's';
+        printf("TBA TASK: TBA_URL in config.h is http://, TBA is only fetched over HTTPS now. Using %s\n", matchUrl);
+        return;
+    }
+    printf("TBA TASK: ERROR: TBA_URL in config.h has to start with https://, matches won't be fetched from %s\n", matchUrl);
+}
 
-            // 2. Fetch Event Data
-            ResponseData evtBuf = { (char*)malloc(4096), 0, 4096 };
-            if (evtBuf.data) evtBuf.data[0] = 0;
+void tba_api_task(void *pvParameters) {
+    printf("TBA TASK: Started and running on Core %d\n", xPortGetCoreID());
 
-            config.url = "https://www.thebluealliance.com/api/v3/team/frc5459/events/2026/simple";
-            config.event_handler = _http_event_handler;
-            config.user_data = &evtBuf;
+    tba_check_url();
+    matchCache.load();
+    eventCache.load();
+    if (snapshotRestored) {
+        // A 304 can leave the restored data standing, if it's what the validators describe
+        matchCache.restored(snapshotSources.matches);
+        eventCache.restored(snapshotSources.events);
+    }
+    int failures = 0; // Polls in a row with a failed fetch
 
-            client = esp_http_client_init(&config);
-            esp_http_client_set_header(client, "X-TBA-Auth-Key", TBA_KEY);
+    webhookQueue = xQueueCreate(WEBHOOK_QUEUE, sizeof(WebhookUpdate));
+    webhook_start(webhookQueue);
 
-            err = esp_http_client_perform(client);
-            int status = esp_http_client_get_status_code(client);
-            printf("TBA TASK: Event Fetch Status = %d\n", status);
+    while (1) {
+        esp_netif_ip_info_t ip_info;
+        if (tba_have_ip(ip_info)) {
 
-            if (err == ESP_OK && status == 200) {
-                printf("TBA TASK: Received %d bytes\n", evtBuf.len);
-                parse_tba_events(evtBuf.data);
-            } else {
+            printf("TBA TASK: IP Found (%d.%d.%d.%d). Fetching TBA...\n",
+                    IP2STR(&ip_info.ip));
+
+            // Matches first, they're what changes during an event
+            MatchListener matches;
+            JsonStream matchJson(&matches);
+            EventListener events;
+            JsonStream eventJson(&events);
+
+            TbaRequest requests[2];
+            tba_queue(requests[0], matchCache, matchJson, TBA_DEADLINE_MS);
+            tba_queue(requests[1], eventCache, eventJson, TBA_DEADLINE_MS);
+            tba_run(requests, 2);
+
+            bool failed = false;
+            bool fresh = false;
+            for (const TbaRequest &req : requests) {
+                failed |= (req.result == TBA_FAILED);
+                fresh |= (req.result == TBA_FRESH);
+            }
+            if (!failed) boot_mark(BOOT_FIRST_DATA);
+
+            // 1. Match Data
+            if (requests[0].result == TBA_FRESH) {
+                DisplayModel &model = displayModel.edit();
+                // Replace the history and schedule with fresh API data
+                memcpy(model.matchHistory, matches.history, sizeof(model.matchHistory));
+                model.matchesCompleted = matches.completed;
+                memcpy(model.schedule, matches.schedule, sizeof(model.schedule));
+                model.currentlyPlaying = matches.currentlyPlaying;
+                displayModel.publish(); // matrix_task only ever sees the finished history
+                matrix_wake();
+            } else if (requests[0].result == TBA_FAILED) {
+                printf("TBA TASK: Match Fetch failed\n");
+            }
+
+            // 2. Event Data
+            if (requests[1].result == TBA_FRESH) {
+                printf("TBA TASK: Received %lu bytes, %d events\n", (unsigned long)eventJson.bytesFed(), events.eventCount);
+                DisplayModel &model = displayModel.edit();
+                if (events.nextDate != 0) {
+                    model.nextEventDate = events.nextDate;
+                    model.nextEventEnd = events.nextEnd;
+                    snprintf(model.nextEventName, sizeof(model.nextEventName), "%s", events.nextName);
+                }
+                displayModel.publish();
+                matrix_wake();
+            } else if (requests[1].result == TBA_FAILED) {
                 printf("TBA TASK: Event Fetch failed\n");
             }
-            esp_http_client_cleanup(client);
-            if (evtBuf.data) free(evtBuf.data);
 
-            // Wait 5 minutes
-            vTaskDelay(pdMS_TO_TICKS(300000));
+            if (fresh) tba_save_snapshot(displayModel.edit());
+            tba_link_report();
+
+            // Wait as long as the schedule says we can get away with
+            failures = failed ? failures + 1 : 0;
+            time_t now;
+            struct tm timeinfo;
+            time(&now);
+            localtime_r(&now, &timeinfo);
+            if (timeinfo.tm_year <= 120) now = 0; // NTP hasn't synced yet
+
+            PollDecision next = nextPoll(displayModel.edit(), now, failures, esp_random());
+            printf("TBA TASK: Next poll in %lu s (%s)\n", (unsigned long)(next.delayMs / 1000), next.reason);
+            tba_wait(next.delayMs);
         } else {
             // Not connected yet, wait 2 seconds and check again
             printf("TBA TASK: Waiting for WiFi IP...\n");
             vTaskDelay(pdMS_TO_TICKS(2000));
-            continue; // Skip the rest and loop back to check IP again
         }
-
-        vTaskDelay(pdMS_TO_TICKS(10000)); // Default fallback delay
     }
 }
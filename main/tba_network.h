@@ -3,4 +3,8 @@
 
 void tba_api_task(void *pvParameters);
 
+// Put the TBA data saved before the last reboot into the display model (and wake the display for it),
+// before networking is up
+bool tba_restore_snapshot();
+
 #endif // TBA_NETWORK_H
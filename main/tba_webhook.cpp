@@ -0,0 +1,252 @@
+#include "tba_webhook.h"
+#include "config.h"
+#include "esp_http_server.h"
+#include "esp_timer.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+
+#define WEBHOOK_CHUNK 512
+
+// "2026mabos_qm42" -> 'Q' 42, "..._sf3m1" -> 'P' 3 (the set), "..._f1m2" -> 'P' 2 (the final)
+static bool parseMatchKey(const char *key, char &type, int &number) {
+    const char *p = strchr(key, '_');
+    if (!p) return false;
+    p++;
+
+    char level[4] = "";
+    int n = 0;
+    while (isalpha((unsigned char)*p) && n < 3) level[n++] = *p++;
+    level[n] = 0;
+    int first = atoi(p);
+    while (isdigit((unsigned char)*p)) p++;
+    int second = (*p == 'm') ? atoi(p + 1) : 0;
+
+    if (strcmp(level, "qm") == 0) {
+        type = 'Q';
+        number = first;
+    } else {
+        type = 'P';
+        number = (strcmp(level, "f") == 0) ? second : first;
+    }
+    return number > 0;
+}
+
+// --- Reading a POST ---
+WebhookReader::WebhookReader(const char *secret) : json(this) {
+    mbedtls_md_init(&md);
+    const mbedtls_md_info_t *info = mbedtls_md_info_from_type(MBEDTLS_MD_SHA256);
+    mdReady = info && mbedtls_md_setup(&md, info, 1) == 0 &&
+              mbedtls_md_hmac_starts(&md, (const unsigned char *)secret, strlen(secret)) == 0;
+}
+
+WebhookReader::~WebhookReader() {
+    mbedtls_md_free(&md);
+}
+
+void WebhookReader::feed(const char *data, int len) {
+    if (mdReady) mbedtls_md_hmac_update(&md, (const unsigned char *)data, len);
+    json.feed(data, len);
+}
+
+bool WebhookReader::finish(const char *hmacHex, WebhookUpdate &update) {
+    unsigned char digest[32];
+    if (!mdReady || mbedtls_md_hmac_finish(&md, digest) != 0) return false;
+    if (strlen(hmacHex) != 64) return false;
+
+    // Every character compared, so the time taken doesn't say how much of a forgery was right
+    static const char hex[] = "0123456789abcdef";
+    uint8_t diff = 0;
+    for (int i = 0; i < 32; i++) {
+        diff |= hex[digest[i] >> 4] ^ tolower((unsigned char)hmacHex[i * 2]);
+        diff |= hex[digest[i] & 0xF] ^ tolower((unsigned char)hmacHex[i * 2 + 1]);
+    }
+    if (diff != 0 || !json.finish()) return false;
+
+    update = {};
+    update.kind = WEBHOOK_IGNORED;
+    if (strcmp(messageType, "verification") == 0) {
+        update.kind = WEBHOOK_VERIFICATION;
+        snprintf(update.verificationKey, sizeof(update.verificationKey), "%s", verificationKey);
+    } else if (strcmp(messageType, "match_score") == 0 && ourAlliance >= 0 && redScore >= 0 && matchNumber > 0) {
+        update.kind = WEBHOOK_MATCH_SCORE;
+        update.type = (strcmp(compLevel, "qm") == 0) ? 'Q' : 'P';
+        update.number = (update.type == 'P' && strcmp(compLevel, "f") != 0) ? setNumber : matchNumber;
+        update.redScore = redScore;
+        update.color = ourAlliance == 0 ? 0xF800 : 0x001F;
+    } else if (strcmp(messageType, "upcoming_match") == 0 && ourAlliance >= 0 &&
+               parseMatchKey(matchKey, update.type, update.number)) {
+        update.kind = WEBHOOK_UPCOMING_MATCH;
+        update.color = ourAlliance == 0 ? 0xF800 : 0x001F;
+        update.estTime = predictedTime ? predictedTime : scheduledTime;
+    }
+    return true;
+}
+
+// message_type: "match_score" | "upcoming_match" | "verification" | ...
+// message_data, match_score:    {"match": {"comp_level", "match_number", "set_number",
+//                                          "alliances": {"red": {"score", "team_keys": [...]}, "blue": {...}}}}
+// message_data, upcoming_match: {"match_key", "team_keys": [red x3, blue x3], "scheduled_time", "predicted_time"}
+// message_data, verification:   {"verification_key"}
+void WebhookReader::onJson(const JsonStream &json, JsonEvent event, const char *value) {
+    int depth = json.depth();
+    if (depth == 1) {
+        if (event == JSON_STRING && strcmp(json.key(), "message_type") == 0) {
+            snprintf(messageType, sizeof(messageType), "%s", value);
+        }
+        return;
+    }
+    if (strcmp(json.key(1), "message_data") != 0) return;
+
+    if (depth == 2) {
+        const char *key = json.key();
+        if (event == JSON_STRING && strcmp(key, "match_key") == 0) snprintf(matchKey, sizeof(matchKey), "%s", value);
+        else if (event == JSON_STRING && strcmp(key, "verification_key") == 0) snprintf(verificationKey, sizeof(verificationKey), "%s", value);
+        else if (event == JSON_NUMBER && strcmp(key, "scheduled_time") == 0) scheduledTime = atoll(value);
+        else if (event == JSON_NUMBER && strcmp(key, "predicted_time") == 0) predictedTime = atoll(value);
+    }
+    else if (depth == 3 && strcmp(json.key(2), "team_keys") == 0) {
+        if (event == JSON_STRING) {
+            if (strcmp(value, WEBHOOK_TEAM_KEY) == 0) ourAlliance = (teamSlot < 3) ? 0 : 1;
+            teamSlot++;
+        }
+    }
+    else if (depth == 3 && strcmp(json.key(2), "match") == 0) {
+        const char *key = json.key();
+        if (event == JSON_STRING && strcmp(key, "comp_level") == 0) snprintf(compLevel, sizeof(compLevel), "%s", value);
+        else if (event == JSON_NUMBER && strcmp(key, "match_number") == 0) matchNumber = atoi(value);
+        else if (event == JSON_NUMBER && strcmp(key, "set_number") == 0) setNumber = atoi(value);
+    }
+    else if (depth >= 5 && strcmp(json.key(2), "match") == 0 && strcmp(json.key(3), "alliances") == 0) {
+        bool red = strcmp(json.key(4), "red") == 0;
+        if (depth == 5 && event == JSON_NUMBER && red && strcmp(json.key(), "score") == 0) {
+            redScore = atoi(value);
+        } else if (depth == 6 && event == JSON_STRING && strcmp(json.key(5), "team_keys") == 0 &&
+                   strcmp(value, WEBHOOK_TEAM_KEY) == 0) {
+            ourAlliance = red ? 0 : 1;
+        }
+    }
+}
+
+// --- Applying ---
+static int matchOrder(const MatchEntry &m) {
+    return (m.type == 'P' ? 1000 : 0) + m.number;
+}
+
+bool webhook_apply(DisplayModel &model, const WebhookUpdate &update) {
+    if (update.kind == WEBHOOK_MATCH_SCORE) {
+        // Same red score the polled history keeps, so the next poll agrees with it. Q3 and playoff set 3
+        // are different matches.
+        GameScore *score = NULL;
+        for (int i = 0; i < model.matchesCompleted; i++) {
+            const GameScore &g = model.matchHistory[i];
+            if (g.type == update.type && g.matchNum == update.number) score = &model.matchHistory[i];
+        }
+        if (!score && model.matchesCompleted < 12) {
+            score = &model.matchHistory[model.matchesCompleted++];
+            *score = {};
+            score->type = update.type;
+            score->matchNum = update.number;
+        }
+        bool changed = false;
+        if (score && score->totalScore != update.redScore) {
+            score->totalScore = update.redScore;
+            changed = true;
+        }
+
+        // It's been played, so it comes off the schedule
+        for (int i = 0; i < 3; i++) {
+            if (model.schedule[i].type != update.type || model.schedule[i].number != update.number) continue;
+            for (int j = i; j < 2; j++) model.schedule[j] = model.schedule[j + 1];
+            model.schedule[2] = {};
+            changed = true;
+            break;
+        }
+        return changed;
+    }
+
+    if (update.kind == WEBHOOK_UPCOMING_MATCH) {
+        MatchEntry entry = { update.type, update.number, update.color, update.estTime };
+        for (MatchEntry &m : model.schedule) {
+            if (m.type == entry.type && m.number == entry.number) {
+                bool changed = m.color != entry.color || m.estTime != entry.estTime;
+                m = entry;
+                return changed;
+            }
+        }
+
+        // In order behind any earlier matches (quals before playoffs), the last one dropping off the end
+        int at = 0;
+        while (at < 3 && model.schedule[at].number != 0 && matchOrder(model.schedule[at]) < matchOrder(entry)) at++;
+        if (at == 3) return false;
+        for (int j = 2; j > at; j--) model.schedule[j] = model.schedule[j - 1];
+        model.schedule[at] = entry;
+        return true;
+    }
+
+    return false;
+}
+
+// --- Server ---
+#ifdef TBA_WEBHOOK_SECRET
+static esp_err_t webhook_post(httpd_req_t *req) {
+    WebhookUpdate update;
+    int64_t receivedUs = esp_timer_get_time();
+
+    char hmac[72];
+    if (httpd_req_get_hdr_value_str(req, "X-TBA-HMAC", hmac, sizeof(hmac)) != ESP_OK) hmac[0] = 0;
+
+    WebhookReader reader(TBA_WEBHOOK_SECRET);
+    char chunk[WEBHOOK_CHUNK];
+    size_t remaining = req->content_len;
+    while (remaining > 0) {
+        int got = httpd_req_recv(req, chunk, remaining < sizeof(chunk) ? remaining : sizeof(chunk));
+        if (got == HTTPD_SOCK_ERR_TIMEOUT) continue;
+        if (got <= 0) return ESP_FAIL;
+        reader.feed(chunk, got);
+        remaining -= got;
+    }
+
+    if (!reader.finish(hmac, update)) {
+        printf("WEBHOOK: Rejected a %u byte POST, bad signature or JSON\n", (unsigned)req->content_len);
+        httpd_resp_send_err(req, HTTPD_401_UNAUTHORIZED, "Bad signature");
+        return ESP_OK;
+    }
+
+    if (update.kind == WEBHOOK_VERIFICATION) {
+        printf("WEBHOOK: Verification key %s\n", update.verificationKey);
+    } else if (update.kind != WEBHOOK_IGNORED) {
+        update.receivedUs = receivedUs;
+        QueueHandle_t queue = (QueueHandle_t)req->user_ctx;
+        if (xQueueSend(queue, &update, 0) != pdTRUE) printf("WEBHOOK: Queue full, dropped an update\n");
+    }
+    httpd_resp_sendstr(req, "OK");
+    return ESP_OK;
+}
+#endif
+
+bool webhook_start(QueueHandle_t queue) {
+#ifdef TBA_WEBHOOK_SECRET
+    httpd_config_t config = HTTPD_DEFAULT_CONFIG();
+    config.stack_size = 6144; // The reader and a receive chunk live on it
+    httpd_handle_t server = NULL;
+    if (httpd_start(&server, &config) != ESP_OK) {
+        printf("WEBHOOK: Couldn't start the server\n");
+        return false;
+    }
+
+    httpd_uri_t uri = {};
+    uri.uri = WEBHOOK_PATH;
+    uri.method = HTTP_POST;
+    uri.handler = webhook_post;
+    uri.user_ctx = queue;
+    httpd_register_uri_handler(server, &uri);
+    printf("WEBHOOK: Listening on port %d%s\n", config.server_port, WEBHOOK_PATH);
+    return true;
+#else
+    (void)queue;
+    printf("WEBHOOK: No TBA_WEBHOOK_SECRET in config.h, push updates are off\n");
+    return false;
+#endif
+}
@@ -0,0 +1,76 @@
+#ifndef TBA_WEBHOOK_H
+#define TBA_WEBHOOK_H
+
+#include <stdint.h>
+#include <time.h>
+#include "display_model.h"
+#include "json_stream.h"
+#include "mbedtls/md.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/queue.h"
+
+#define WEBHOOK_PATH     "/tba"
+#define WEBHOOK_TEAM_KEY "frc5459" // Same team as the polled URLs
+#define WEBHOOK_QUEUE    8         // Updates waiting for tba_api_task
+
+enum WebhookKind {
+    WEBHOOK_IGNORED,        // Valid, but nothing we show (another team, a message type we don't use, ...)
+    WEBHOOK_MATCH_SCORE,    // One of our matches has been scored
+    WEBHOOK_UPCOMING_MATCH, // One of our matches is about to be queued
+    WEBHOOK_VERIFICATION    // TBA checking the URL when it's added, key needs entering on the account page
+};
+
+// What a TBA push comes down to, passed from the server to tba_api_task through a queue
+struct WebhookUpdate {
+    WebhookKind kind;
+    char type;       // 'Q' or 'P'
+    int number;
+    int redScore;
+    uint16_t color;  // Our alliance, 0xF800 (Red) or 0x001F (Blue)
+    time_t estTime;
+    char verificationKey[48];
+    int64_t receivedUs; // esp_timer time the request came in, for the apply latency
+};
+
+// Reads one webhook body as it arrives: the HMAC is worked out over the same pieces the parser sees,
+// so nothing keeps the body, and the update is only believed once the signature has checked out.
+//
+// TBA signs with X-TBA-HMAC, the hex HMAC-SHA256 of the body keyed with the secret the webhook was
+// registered with.
+class WebhookReader : public JsonListener {
+public:
+    explicit WebhookReader(const char *secret);
+    ~WebhookReader();
+
+    void feed(const char *data, int len);
+
+    // End of the body. False if it isn't signed by our secret or isn't valid JSON, otherwise fills in update
+    bool finish(const char *hmacHex, WebhookUpdate &update);
+
+    void onJson(const JsonStream &json, JsonEvent event, const char *value) override;
+
+private:
+    JsonStream json;
+    mbedtls_md_context_t md;
+    bool mdReady = false;
+
+    char messageType[24] = "";
+    char compLevel[4] = "";
+    int matchNumber = 0;
+    int setNumber = 0;
+    int redScore = -1;
+    int ourAlliance = -1; // 0 red, 1 blue, -1 not in the match
+    int teamSlot = 0;     // Position in team_keys, red's three come first
+    time_t scheduledTime = 0;
+    time_t predictedTime = 0;
+    char matchKey[32] = "";
+    char verificationKey[48] = "";
+};
+
+// Fold an update into the model, false if it didn't change anything
+bool webhook_apply(DisplayModel &model, const WebhookUpdate &update);
+
+// Start the HTTP server that takes TBA's POSTs on WEBHOOK_PATH, queueing the updates onto queue
+bool webhook_start(QueueHandle_t queue);
+
+#endif // TBA_WEBHOOK_H
@@ -0,0 +1,60 @@
+#include "ticker_store.h"
+#include <stdio.h>
+#include <stdarg.h>
+
+bool TickerStore::add(const char *fmt, ...) {
+    if (count == TICKER_MAX_MESSAGES) return false;
+
+    char *dst = &text[used];
+    uint16_t room = TICKER_ARENA_SIZE - used;
+
+    va_list args;
+    va_start(args, fmt);
+    int len = vsnprintf(dst, room, fmt, args);
+    va_end(args);
+    if (len < 0 || len >= room) return false;
+
+    // Lay out the glyphs and measure the ink the same way Adafruit_GFX::getTextBounds() does
+    int16_t *xs = &glyphX[used];
+    int16_t x = 0;
+    int16_t minX = INT16_MAX, maxX = -1;
+
+    for (int i = 0; i < len; i++) {
+        uint8_t c = (uint8_t)dst[i];
+        xs[i] = x;
+        if (c < font->first || c > font->last) continue;
+
+        const GFXglyph *g = &font->glyph[c - font->first];
+        int16_t x1 = x + g->xOffset;
+        int16_t x2 = x1 + g->width - 1;
+        if (x1 < minX) minX = x1;
+        if (x2 > maxX) maxX = x2;
+        x += g->xAdvance;
+    }
+
+    Message &m = messages[count++];
+    m.text = dst;
+    m.glyphX = xs;
+    m.length = len;
+    m.width = (maxX >= minX) ? maxX - minX + 1 : 0;
+
+    used += len + 1;
+    return true;
+}
+
+void TickerStore::draw(GFXcanvas16 *canvas, uint8_t i, int16_t x, int16_t y, uint16_t color,
+                       int16_t clipX0, int16_t clipX1) const {
+    const Message &m = messages[i];
+
+    for (uint16_t k = 0; k < m.length; k++) {
+        uint8_t c = (uint8_t)m.text[k];
+        if (c < font->first || c > font->last) continue;
+
+        const GFXglyph *g = &font->glyph[c - font->first];
+        int16_t gx = x + m.glyphX[k];
+        if (gx + g->xOffset >= clipX1) break; // Glyphs only go rightwards from here
+        if (g->width == 0 || gx + g->xOffset + g->width <= clipX0) continue;
+
+        canvas->drawChar(gx, y, c, color, color, 1);
+    }
+}
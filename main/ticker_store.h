@@ -0,0 +1,45 @@
+#ifndef TICKER_STORE_H
+#define TICKER_STORE_H
+
+#include <stdint.h>
+#include "Adafruit_GFX.h"
+
+#define TICKER_MAX_MESSAGES 4
+#define TICKER_ARENA_SIZE 256 // Characters across all messages, including terminators
+
+// Ticker messages, formatted and laid out once when they change. Text and glyph positions live in fixed
+// arrays inside the store, so nothing is allocated - not when adding messages, and not when drawing them.
+class TickerStore {
+public:
+    struct Message {
+        const char *text;      // NUL terminated, in the arena
+        const int16_t *glyphX; // Cursor offset of each character from the start of the message
+        uint16_t length;
+        uint16_t width;        // Pixel width, the same as getTextBounds() gives
+    };
+
+    explicit TickerStore(const GFXfont *font) : font(font) {}
+
+    void clear() { used = 0; count = 0; }
+
+    // Format and measure a message, false if it doesn't fit
+    bool add(const char *fmt, ...) __attribute__((format(printf, 2, 3)));
+
+    uint8_t size() const { return count; }
+    const Message &operator[](uint8_t i) const { return messages[i]; }
+
+    // Draw a message with the cursor starting at x on baseline y. Glyphs entirely
+    // outside clipX0..clipX1 are skipped. The canvas font has to be this store's font.
+    void draw(GFXcanvas16 *canvas, uint8_t i, int16_t x, int16_t y, uint16_t color,
+              int16_t clipX0, int16_t clipX1) const;
+
+private:
+    const GFXfont *font;
+    char text[TICKER_ARENA_SIZE];
+    int16_t glyphX[TICKER_ARENA_SIZE];
+    uint16_t used = 0;
+    Message messages[TICKER_MAX_MESSAGES];
+    uint8_t count = 0;
+};
+
+#endif // TICKER_STORE_H
@@ -0,0 +1,108 @@
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <cstdint>
+
+#include "fast_math.h"
+
+// fast_math.h (main/) against the libm calls it replaced: accuracy bounds over every input that matters (exits
+// non-zero if one is exceeded), then host timings of each helper next to the libm / float version. The S3 gap is
+// wider than a desktop's, it has no double precision FPU.
+//
+// g++ -O2 -I../main -o fast_math_bench.exe fast_math_bench.cpp
+
+static volatile uint32_t sink;
+
+template <class F>
+static double ns_per_call(F f)
+{
+    const uint32_t calls = 20000000;
+    auto start = std::chrono::steady_clock::now();
+    uint32_t acc = 0;
+    for (uint32_t i = 0; i < calls; i++)
+        acc += f(i);
+    sink = acc;
+    return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / calls;
+}
+
+static int failures = 0;
+
+static void bound(const char *what, double worst, double allowed)
+{
+    bool ok = worst <= allowed;
+    std::cout << std::left << std::setw(28) << what << "worst " << std::setw(10) << worst << "allowed " << allowed
+              << (ok ? "" : "  FAIL") << std::endl;
+    if (!ok)
+        failures++;
+}
+
+int main()
+{
+    // --- Accuracy ---
+    double worst = 0;
+    for (int theta = 0; theta < 256; theta++)
+        worst = std::max(worst, std::fabs(sin8(theta) - (128 + 127 * std::sin(theta * 2 * M_PI / 256))));
+    bound("sin8 vs 128 + 127 sin", worst, 1.0);
+
+    worst = 0;
+    for (int theta = 0; theta < 256; theta++)
+        worst = std::max(worst, std::fabs(cos8(theta) - (128 + 127 * std::cos(theta * 2 * M_PI / 256))));
+    bound("cos8 vs 128 + 127 cos", worst, 1.0);
+
+    worst = 0;
+    for (int i = 0; i < 256; i++)
+        for (int s = 0; s < 256; s++)
+            worst = std::max(worst, std::fabs(scale8(i, s) - i * s / 255.0));
+    bound("scale8 vs i * s / 255", worst, 1.0);
+
+    int wrong = 0;
+    for (int i = 0; i < 256; i++)
+        wrong += scale8(i, 255) != i;
+    bound("scale8(i, 255) != i", wrong, 0);
+
+    // The border pulses: 150 +/- 100 over 1570ms, as sinf() drew them
+    worst = 0;
+    for (uint32_t ms = 0; ms < 3 * 1570; ms++)
+        worst = std::max(worst, std::fabs(beatsin8(ms, 1570, 50, 250) - (150 + 100 * std::sin(ms * 2 * M_PI / 1570))));
+    bound("beatsin8 vs the sinf pulse", worst, 4.0);
+
+    worst = 0;
+    for (int32_t a = -3 * Q16_ONE; a <= 3 * Q16_ONE; a += 997)
+        for (int32_t b = -2 * Q16_ONE; b <= 2 * Q16_ONE; b += 1009)
+            worst = std::max(worst, std::fabs(q16Mul(a, b) - std::floor((double)a * b / Q16_ONE)));
+    bound("q16Mul vs double (units)", worst, 0.0);
+
+    worst = 0;
+    for (int32_t t = 0; t <= Q16_ONE; t += 37)
+        worst = std::max(worst, std::fabs(q16Lerp(-40, 250, t) - (-40 + 290.0 * t / Q16_ONE)));
+    bound("q16Lerp vs double", worst, 1.0);
+    bound("q16Lerp end points", (q16Lerp(-40, 250, 0) != -40) + (q16Lerp(-40, 250, Q16_ONE) != 250), 0);
+
+    wrong = 0;
+    for (int32_t v = 0; v < 612; v++)
+        for (int32_t step = -1300; step <= 1300; step += 7)
+        {
+            double expected = std::fmod((double)v + step, 612.0);
+            if (expected < 0)
+                expected += 612;
+            wrong += wrapAdd(v, step, 612) != (int32_t)expected;
+        }
+    bound("wrapAdd vs fmod", wrong, 0);
+
+    // --- Speed ---
+    std::cout << std::endl << "ns per call, host:" << std::endl;
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << "  sinf pulse    " << ns_per_call([](uint32_t ms) { return (uint32_t)(150 + (int)(100 * sinf((ms % 1570) * (float)(2 * M_PI) / 1570))); }) << std::endl;
+    std::cout << "  beatsin8      " << ns_per_call([](uint32_t ms) { return (uint32_t)beatsin8(ms, 1570, 50, 250); }) << std::endl;
+    std::cout << "  fmod wrap     " << ns_per_call([](uint32_t i) { float p = fmodf(i * 1.2f, 616.0f); if (p < 0) p += 616.0f; return (uint32_t)p; }) << std::endl;
+    std::cout << "  wrapAdd       " << ns_per_call([](uint32_t i) { return (uint32_t)wrapAdd(i, 307, 612); }) << std::endl;
+    std::cout << "  float lerp    " << ns_per_call([](uint32_t i) { float t = (i & 0xFFFF) / 65536.0f; return (uint32_t)(10 + (250 - 10) * t); }) << std::endl;
+    std::cout << "  q16Lerp       " << ns_per_call([](uint32_t i) { return (uint32_t)q16Lerp(10, 250, i & 0xFFFF); }) << std::endl;
+    std::cout << "  float zoom    " << ns_per_call([](uint32_t i) { float z = 0.5f + (i & 0xFF) / 512.0f; return (uint32_t)((i & 63) * z); }) << std::endl;
+    std::cout << "  q16Mul zoom   " << ns_per_call([](uint32_t i) { q16_t z = Q16_ONE / 2 + ((i & 0xFF) << 7); return (uint32_t)(q16Mul((i & 63) << Q16_SHIFT, z) >> Q16_SHIFT); }) << std::endl;
+
+    std::cout << (failures ? "FAILED" : "PASSED") << std::endl;
+    return failures ? 1 : 0;
+}
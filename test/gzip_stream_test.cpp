@@ -0,0 +1,230 @@
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <random>
+#include <zlib.h>
+
+#include "gzip_stream.h"
+
+// GzipStream (main/gzip_stream.h) on real gzip streams: the TBA payloads in tba_payloads/ compressed by zlib at
+// several levels and strategies, with and without the optional header fields, fed 1 byte at a time, whole and in
+// random sized pieces. The JSON events have to match parsing the plain text and the trailer has to check out.
+// Then corrupted, truncated and over-long streams, which mustn't.
+//
+// host/miniz.cpp stands in for the ROM tinfl, reading ahead past the deflate data into its bit buffer the way
+// tinfl does, so the trailer bytes it swallows have to be recovered. Run from this directory.
+//
+// g++ -O2 -Ihost -I../main -o gzip_stream_test.exe gzip_stream_test.cpp ../main/gzip_stream.cpp
+//     ../main/json_stream.cpp host/miniz.cpp -lz
+
+static const int RANDOM_SPLITS = 40;
+
+static int failures = 0;
+
+static void check(bool ok, const std::string &what)
+{
+    if (!ok)
+    {
+        std::cout << "  FAIL  " << what << std::endl;
+        failures++;
+    }
+}
+
+// Every event, its depth, key and value, folded into a hash
+class Hasher : public JsonListener
+{
+public:
+    uint64_t events = 0;
+    uint64_t hash = 1469598103934665603ull;
+
+    void onJson(const JsonStream &json, JsonEvent event, const char *value) override
+    {
+        events++;
+        mix(event * 31 + json.depth());
+        for (const char *p = json.key(); p && *p; p++)
+            mix(*p);
+        for (const char *p = value; p && *p; p++)
+            mix(*p);
+    }
+
+private:
+    void mix(uint64_t v) { hash = (hash ^ v) * 1099511628211ull; }
+};
+
+static std::string gzip(const std::string &plain, int level, int strategy, bool headerFields)
+{
+    z_stream z = {};
+    deflateInit2(&z, level, Z_DEFLATED, 15 + 16, 8, strategy); // + 16: gzip wrapper
+    gz_header header = {};
+    char name[] = "matches.json", comment[] = "TBA";
+    unsigned char extra[] = {'T', 'B', 3, 0, 'a', 'p', 'i'};
+    if (headerFields)
+    {
+        header.name = (Bytef *)name;
+        header.comment = (Bytef *)comment;
+        header.extra = extra;
+        header.extra_len = sizeof(extra);
+        header.hcrc = 1;
+        deflateSetHeader(&z, &header);
+    }
+    std::string out(deflateBound(&z, plain.size()) + 64, '\0');
+    z.next_in = (Bytef *)plain.data();
+    z.avail_in = plain.size();
+    z.next_out = (Bytef *)&out[0];
+    z.avail_out = out.size();
+    deflate(&z, Z_FINISH);
+    out.resize(z.total_out);
+    deflateEnd(&z);
+    return out;
+}
+
+// Feeds gz in the given pieces. True if every feed was accepted and finish() says the member was whole.
+static bool inflate(const std::string &gz, const std::vector<size_t> &pieces, Hasher &out, GzipStream &stream)
+{
+    JsonStream json(&out);
+    stream.begin();
+    bool accepted = true;
+    size_t at = 0;
+    for (size_t n : pieces)
+    {
+        accepted = stream.feed(gz.data() + at, (int)n, json) && accepted;
+        at += n;
+    }
+    return accepted && stream.finish() && json.finish();
+}
+
+static std::vector<size_t> split(size_t total, size_t piece)
+{
+    std::vector<size_t> pieces;
+    for (size_t at = 0; at < total; at += piece)
+        pieces.push_back(std::min(piece, total - at));
+    return pieces;
+}
+
+static std::vector<size_t> split_random(size_t total, std::mt19937 &random)
+{
+    std::uniform_int_distribution<size_t> size(1, 1500);
+    std::vector<size_t> pieces;
+    for (size_t at = 0; at < total;)
+    {
+        size_t n = std::min(size(random), total - at);
+        pieces.push_back(n);
+        at += n;
+    }
+    return pieces;
+}
+
+static bool rejected(const std::string &gz, const std::string &what)
+{
+    Hasher h;
+    GzipStream stream;
+    bool ok = !inflate(gz, split(gz.size(), 1), h, stream) && !inflate(gz, {gz.size()}, h, stream);
+    check(ok, what + " accepted");
+    return ok;
+}
+
+int main()
+{
+    std::mt19937 random(5459);
+    int streams = 0, feeds = 0;
+
+    for (const char *file : {"event_matches.json", "team_matches.json", "events.json", "team.json"})
+    {
+        std::ifstream in(std::string("tba_payloads/") + file, std::ios::binary);
+        std::stringstream text;
+        text << in.rdbuf();
+        std::string plain = text.str();
+        if (plain.empty())
+        {
+            check(false, std::string("couldn't read tba_payloads/") + file + " (run from test/)");
+            continue;
+        }
+
+        Hasher expected;
+        JsonStream json(&expected);
+        json.feed(plain.data(), plain.size());
+        json.finish();
+
+        const struct { int level, strategy; const char *name; } settings[] = {
+            {1, Z_DEFAULT_STRATEGY, "level 1"},  {6, Z_DEFAULT_STRATEGY, "level 6"}, {9, Z_DEFAULT_STRATEGY, "level 9"},
+            {6, Z_FILTERED, "filtered"},         {6, Z_HUFFMAN_ONLY, "huffman only"}, {6, Z_RLE, "rle"},
+            {6, Z_FIXED, "fixed codes"},
+        };
+        size_t smallest = SIZE_MAX;
+        for (const auto &s : settings)
+        {
+            for (bool headerFields : {false, true})
+            {
+                std::string gz = gzip(plain, s.level, s.strategy, headerFields);
+                smallest = std::min(smallest, gz.size());
+                std::string what = std::string(file) + ", " + s.name + (headerFields ? ", header fields" : "");
+                streams++;
+
+                std::vector<std::vector<size_t>> ways = {split(gz.size(), 1), {gz.size()}};
+                for (int i = 0; i < RANDOM_SPLITS; i++)
+                    ways.push_back(split_random(gz.size(), random));
+
+                for (const auto &pieces : ways)
+                {
+                    Hasher got;
+                    GzipStream stream;
+                    bool ok = inflate(gz, pieces, got, stream);
+                    feeds++;
+                    if (!ok || got.events != expected.events || got.hash != expected.hash ||
+                        stream.bytesOut != plain.size() || stream.bytesIn != gz.size())
+                    {
+                        check(false, what + " in " + std::to_string(pieces.size()) + " pieces");
+                        break;
+                    }
+                }
+            }
+        }
+        std::cout << file << ": " << plain.size() << " bytes, " << smallest << " gzipped" << std::endl;
+    }
+
+    // --- Streams that mustn't check out ---
+    std::ifstream in("tba_payloads/team_matches.json", std::ios::binary);
+    std::stringstream text;
+    text << in.rdbuf();
+    std::string gz = gzip(text.str(), 6, Z_DEFAULT_STRATEGY, false);
+
+    for (int i = 1; i <= 8; i++)
+    {
+        std::string bad = gz;
+        bad[bad.size() - i] ^= 0x01;
+        rejected(bad, std::string(i > 4 ? "CRC" : "length") + " byte " + std::to_string(8 - i) + " changed");
+    }
+    for (int cut = 1; cut <= 12; cut++)
+        rejected(gz.substr(0, gz.size() - cut), std::to_string(cut) + " bytes short");
+    rejected(gz + '\0', "a byte after the trailer");
+    rejected(gz + gz, "a second member");
+    std::string bad = gz;
+    bad[0] = 0;
+    rejected(bad, "bad magic");
+    bad = gz;
+    bad[3] |= 0x20;
+    rejected(bad, "reserved flag");
+    bad = gz;
+    bad[20] ^= 0xFF;
+    rejected(bad, "corrupt deflate data");
+
+    // begin() again part way through one response starts the next cleanly
+    {
+        Hasher first, second, expected;
+        JsonStream json(&first);
+        GzipStream stream;
+        stream.begin();
+        stream.feed(gz.data(), 200, json);
+        bool ok = inflate(gz, split(gz.size(), 333), second, stream);
+        JsonStream plain(&expected);
+        plain.feed(text.str().data(), text.str().size());
+        check(ok && second.hash == expected.hash, "begin() after an abandoned response");
+    }
+
+    std::cout << streams << " streams, " << feeds << " ways of feeding them, inflater memory "
+              << GzipStream::memoryBytes() << " bytes" << std::endl;
+    std::cout << (failures ? "FAILED" : "PASSED") << std::endl;
+    return failures ? 1 : 0;
+}
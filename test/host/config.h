@@ -0,0 +1,8 @@
+#ifndef HOST_CONFIG_H
+#define HOST_CONFIG_H
+
+// Host builds' stand-in for main/config.h (which holds real keys and isn't checked in)
+
+#define TBA_WEBHOOK_SECRET "host-replay-secret"
+
+#endif // HOST_CONFIG_H
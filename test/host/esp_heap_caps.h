@@ -0,0 +1,17 @@
+#ifndef HOST_ESP_HEAP_CAPS_H
+#define HOST_ESP_HEAP_CAPS_H
+
+#include <stdlib.h>
+#include <stdint.h>
+
+// Host stand-in for esp_heap_caps: one heap. Allocations come back zeroed, which host/miniz.cpp relies on.
+
+#define MALLOC_CAP_8BIT   (1 << 2)
+#define MALLOC_CAP_DMA    (1 << 3)
+#define MALLOC_CAP_SPIRAM (1 << 10)
+
+static inline void *heap_caps_malloc(size_t size, uint32_t) { return calloc(1, size); }
+static inline void *heap_caps_malloc_prefer(size_t size, size_t, ...) { return calloc(1, size); }
+static inline void heap_caps_free(void *p) { free(p); }
+
+#endif // HOST_ESP_HEAP_CAPS_H
@@ -0,0 +1,146 @@
+#include "esp_http_client.h"
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <cstring>
+#include <cstdlib>
+#include <strings.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <unistd.h>
+
+struct esp_http_client {
+    esp_http_client_config_t config;
+    std::string url;
+    std::vector<std::pair<std::string, std::string>> headers;
+    int status = 0;
+};
+
+esp_http_client_handle_t esp_http_client_init(const esp_http_client_config_t *config)
+{
+    esp_http_client *client = new esp_http_client;
+    client->config = *config;
+    client->url = config->url;
+    return client;
+}
+
+esp_err_t esp_http_client_set_url(esp_http_client_handle_t client, const char *url)
+{
+    client->url = url;
+    return ESP_OK;
+}
+
+esp_err_t esp_http_client_delete_header(esp_http_client_handle_t client, const char *key)
+{
+    auto &h = client->headers;
+    h.erase(std::remove_if(h.begin(), h.end(), [key](const std::pair<std::string, std::string> &p) { return strcasecmp(p.first.c_str(), key) == 0; }), h.end());
+    return ESP_OK;
+}
+
+esp_err_t esp_http_client_set_header(esp_http_client_handle_t client, const char *key, const char *value)
+{
+    esp_http_client_delete_header(client, key);
+    client->headers.push_back({key, value});
+    return ESP_OK;
+}
+
+esp_err_t esp_http_client_set_user_data(esp_http_client_handle_t client, void *data)
+{
+    client->config.user_data = data;
+    return ESP_OK;
+}
+
+int esp_http_client_get_status_code(esp_http_client_handle_t client) { return client->status; }
+
+esp_err_t esp_http_client_cleanup(esp_http_client_handle_t client)
+{
+    delete client;
+    return ESP_OK;
+}
+
+static void send_event(esp_http_client_handle_t client, esp_http_client_event_id_t id, const char *data = nullptr, int len = 0,
+                       const char *key = nullptr, const char *value = nullptr)
+{
+    esp_http_client_event_t evt = {};
+    evt.event_id = id;
+    evt.client = client;
+    evt.data = (void *)data;
+    evt.data_len = len;
+    evt.user_data = client->config.user_data;
+    evt.header_key = (char *)key;
+    evt.header_value = (char *)value;
+    if (client->config.event_handler)
+        client->config.event_handler(&evt);
+}
+
+esp_err_t esp_http_client_perform(esp_http_client_handle_t client)
+{
+    client->status = 0;
+
+    // http://host:port/path
+    const std::string &url = client->url;
+    size_t hostStart = url.find("://");
+    hostStart = (hostStart == std::string::npos) ? 0 : hostStart + 3;
+    size_t pathStart = url.find('/', hostStart);
+    std::string hostPort = url.substr(hostStart, pathStart - hostStart);
+    std::string path = (pathStart == std::string::npos) ? "/" : url.substr(pathStart);
+    size_t colon = hostPort.find(':');
+    std::string host = hostPort.substr(0, colon);
+    int port = (colon == std::string::npos) ? 80 : atoi(hostPort.c_str() + colon + 1);
+
+    int s = socket(AF_INET, SOCK_STREAM, 0);
+    sockaddr_in addr = {};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(port);
+    if (inet_pton(AF_INET, host == "localhost" ? "127.0.0.1" : host.c_str(), &addr.sin_addr) != 1 ||
+        connect(s, (sockaddr *)&addr, sizeof(addr)) != 0)
+    {
+        close(s);
+        send_event(client, HTTP_EVENT_ERROR);
+        return ESP_FAIL;
+    }
+    send_event(client, HTTP_EVENT_ON_CONNECTED);
+
+    std::string request = "GET " + path + " HTTP/1.0\r\nHost: " + hostPort + "\r\n";
+    for (auto &h : client->headers)
+        request += h.first + ": " + h.second + "\r\n";
+    request += "\r\n";
+    if (write(s, request.data(), request.size()) != (ssize_t)request.size())
+    {
+        close(s);
+        return ESP_FAIL;
+    }
+    send_event(client, HTTP_EVENT_HEADERS_SENT);
+
+    std::string response;
+    char buf[4096];
+    ssize_t n;
+    while ((n = read(s, buf, sizeof(buf))) > 0)
+        response.append(buf, n);
+    close(s);
+
+    size_t headEnd = response.find("\r\n\r\n");
+    if (response.compare(0, 5, "HTTP/") != 0 || headEnd == std::string::npos)
+        return ESP_FAIL;
+    client->status = atoi(response.c_str() + response.find(' ') + 1);
+
+    for (size_t at = response.find("\r\n") + 2; at < headEnd;)
+    {
+        size_t end = response.find("\r\n", at);
+        std::string line = response.substr(at, end - at);
+        size_t sep = line.find(':');
+        std::string key = line.substr(0, sep);
+        std::string value = line.substr(line.find_first_not_of(' ', sep + 1));
+        send_event(client, HTTP_EVENT_ON_HEADER, nullptr, 0, key.c_str(), value.c_str());
+        at = end + 2;
+    }
+
+    int piece = client->config.buffer_size > 0 ? client->config.buffer_size : 512;
+    for (size_t at = headEnd + 4; at < response.size(); at += piece)
+        send_event(client, HTTP_EVENT_ON_DATA, response.data() + at, (int)std::min(response.size() - at, (size_t)piece));
+
+    send_event(client, HTTP_EVENT_ON_FINISH);
+    send_event(client, HTTP_EVENT_DISCONNECTED);
+    return ESP_OK;
+}
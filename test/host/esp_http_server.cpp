@@ -0,0 +1,220 @@
+#include "esp_http_server.h"
+#include <string>
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <cstring>
+#include <cstdio>
+#include <cstdlib>
+#include <strings.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <unistd.h>
+
+struct Server {
+    int listener = -1;
+    std::atomic<int> connection{-1};
+    std::vector<httpd_uri_t> uris;
+    std::thread thread;
+};
+
+// One request on a connection: its headers, and whatever of the body came in with them
+struct Connection {
+    int sock;
+    std::string buffered;
+    std::vector<std::pair<std::string, std::string>> headers;
+    size_t bodyLeft = 0;
+    bool responded = false;
+};
+
+static int lastPort = 0;
+
+int httpd_host_port(void) { return lastPort; }
+
+static bool send_all(int sock, const std::string &data)
+{
+    for (size_t at = 0; at < data.size();)
+    {
+        ssize_t n = send(sock, data.data() + at, data.size() - at, MSG_NOSIGNAL);
+        if (n <= 0)
+            return false;
+        at += n;
+    }
+    return true;
+}
+
+static esp_err_t respond(httpd_req_t *req, const char *status, const char *body)
+{
+    Connection *c = (Connection *)req->aux;
+    c->responded = true;
+    std::string response = std::string("HTTP/1.1 ") + status + "\r\nContent-Type: text/plain\r\nContent-Length: " +
+                           std::to_string(strlen(body)) + "\r\n\r\n" + body;
+    return send_all(c->sock, response) ? ESP_OK : ESP_FAIL;
+}
+
+esp_err_t httpd_resp_sendstr(httpd_req_t *req, const char *str) { return respond(req, "200 OK", str); }
+
+esp_err_t httpd_resp_send_err(httpd_req_t *req, httpd_err_code_t error, const char *msg)
+{
+    static const char *const status[] = {"400 Bad Request", "401 Unauthorized", "404 Not Found", "500 Internal Server Error"};
+    return respond(req, status[error], msg);
+}
+
+esp_err_t httpd_req_get_hdr_value_str(httpd_req_t *req, const char *field, char *val, size_t val_size)
+{
+    for (auto &h : ((Connection *)req->aux)->headers)
+    {
+        if (strcasecmp(h.first.c_str(), field) != 0)
+            continue;
+        if (h.second.size() >= val_size)
+            return ESP_FAIL;
+        strcpy(val, h.second.c_str());
+        return ESP_OK;
+    }
+    return ESP_ERR_NOT_FOUND;
+}
+
+int httpd_req_recv(httpd_req_t *req, char *buf, size_t buf_len)
+{
+    Connection *c = (Connection *)req->aux;
+    size_t want = buf_len < c->bodyLeft ? buf_len : c->bodyLeft;
+    if (want == 0)
+        return 0;
+    ssize_t got;
+    if (!c->buffered.empty())
+    {
+        got = c->buffered.size() < want ? c->buffered.size() : want;
+        memcpy(buf, c->buffered.data(), got);
+        c->buffered.erase(0, got);
+    }
+    else
+    {
+        got = recv(c->sock, buf, want, 0);
+        if (got <= 0)
+            return HTTPD_SOCK_ERR_FAIL;
+    }
+    c->bodyLeft -= got;
+    return (int)got;
+}
+
+// Requests on one keep-alive connection until the client closes it or a handler fails
+static void serve_connection(Server *server, int sock)
+{
+    Connection c;
+    c.sock = sock;
+    char buf[1024];
+    while (true)
+    {
+        size_t headEnd;
+        while ((headEnd = c.buffered.find("\r\n\r\n")) == std::string::npos)
+        {
+            ssize_t n = recv(sock, buf, sizeof(buf), 0);
+            if (n <= 0)
+                return;
+            c.buffered.append(buf, n);
+        }
+        std::string head = c.buffered.substr(0, headEnd);
+        c.buffered.erase(0, headEnd + 4);
+
+        httpd_req_t req = {};
+        req.handle = server;
+        req.aux = &c;
+        size_t lineEnd = head.find("\r\n");
+        std::string line = head.substr(0, lineEnd);
+        std::string method = line.substr(0, line.find(' '));
+        std::string uri = line.substr(method.size() + 1, line.rfind(' ') - method.size() - 1);
+        req.method = method == "POST" ? HTTP_POST : HTTP_GET;
+        snprintf(req.uri, sizeof(req.uri), "%s", uri.c_str());
+
+        c.headers.clear();
+        for (size_t at = lineEnd == std::string::npos ? head.size() : lineEnd + 2; at < head.size();)
+        {
+            size_t end = head.find("\r\n", at);
+            if (end == std::string::npos)
+                end = head.size();
+            std::string h = head.substr(at, end - at);
+            size_t sep = h.find(':');
+            size_t value = h.find_first_not_of(' ', sep + 1);
+            if (sep != std::string::npos)
+                c.headers.push_back({h.substr(0, sep), value == std::string::npos ? "" : h.substr(value)});
+            at = end + 2;
+        }
+        char length[16];
+        req.content_len = httpd_req_get_hdr_value_str(&req, "Content-Length", length, sizeof(length)) == ESP_OK ? atoi(length) : 0;
+        c.bodyLeft = req.content_len;
+        c.responded = false;
+
+        const httpd_uri_t *handler = nullptr;
+        for (auto &u : server->uris)
+            if (uri == u.uri && req.method == u.method)
+                handler = &u;
+
+        esp_err_t err = ESP_OK;
+        if (handler)
+        {
+            req.user_ctx = handler->user_ctx;
+            err = handler->handler(&req);
+        }
+        else
+            httpd_resp_send_err(&req, HTTPD_404_NOT_FOUND, "Not found");
+        if (err != ESP_OK)
+            return;
+
+        // Whatever of the body the handler left
+        while (c.bodyLeft > 0 && httpd_req_recv(&req, buf, sizeof(buf)) > 0)
+            ;
+        if (!c.responded)
+            httpd_resp_sendstr(&req, "");
+    }
+}
+
+esp_err_t httpd_start(httpd_handle_t *handle, const httpd_config_t *config)
+{
+    Server *server = new Server;
+    server->listener = socket(AF_INET, SOCK_STREAM, 0);
+    sockaddr_in addr = {};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    addr.sin_port = htons(config->server_port);
+    socklen_t len = sizeof(addr);
+    if (bind(server->listener, (sockaddr *)&addr, sizeof(addr)) != 0 || listen(server->listener, 4) != 0 ||
+        getsockname(server->listener, (sockaddr *)&addr, &len) != 0)
+    {
+        close(server->listener);
+        delete server;
+        return ESP_FAIL;
+    }
+    lastPort = ntohs(addr.sin_port);
+
+    server->thread = std::thread([server] {
+        int sock;
+        while ((sock = accept(server->listener, nullptr, nullptr)) >= 0)
+        {
+            server->connection = sock;
+            serve_connection(server, sock);
+            server->connection = -1;
+            close(sock);
+        }
+    });
+    *handle = server;
+    return ESP_OK;
+}
+
+esp_err_t httpd_stop(httpd_handle_t handle)
+{
+    Server *server = (Server *)handle;
+    shutdown(server->listener, SHUT_RDWR);
+    int sock = server->connection;
+    if (sock >= 0)
+        shutdown(sock, SHUT_RDWR);
+    server->thread.join();
+    close(server->listener);
+    delete server;
+    return ESP_OK;
+}
+
+esp_err_t httpd_register_uri_handler(httpd_handle_t handle, const httpd_uri_t *uri)
+{
+    ((Server *)handle)->uris.push_back(*uri);
+    return ESP_OK;
+}
@@ -0,0 +1,61 @@
+#ifndef HOST_ESP_HTTP_SERVER_H
+#define HOST_ESP_HTTP_SERVER_H
+
+#include <stddef.h>
+#include "esp_err.h"
+
+// Host stand-in for esp_http_server: one thread serving one keep-alive connection at a time on 127.0.0.1,
+// as the device's single httpd task does. Handlers read the body with httpd_req_recv() as it arrives.
+//
+// Unlike the device, server_port defaults to 0, any free port; httpd_host_port() says which it got.
+
+typedef void *httpd_handle_t;
+
+typedef enum { HTTP_GET, HTTP_POST } httpd_method_t;
+
+typedef enum {
+    HTTPD_400_BAD_REQUEST,
+    HTTPD_401_UNAUTHORIZED,
+    HTTPD_404_NOT_FOUND,
+    HTTPD_500_INTERNAL_SERVER_ERROR,
+} httpd_err_code_t;
+
+#define HTTPD_SOCK_ERR_FAIL    -1
+#define HTTPD_SOCK_ERR_TIMEOUT -3
+
+typedef struct {
+    unsigned stack_size;
+    unsigned short server_port;
+} httpd_config_t;
+
+#define HTTPD_DEFAULT_CONFIG() { 4096, 0 }
+
+typedef struct httpd_req {
+    httpd_handle_t handle;
+    int method;
+    char uri[128];
+    size_t content_len;
+    void *user_ctx;
+    void *aux; // The connection
+} httpd_req_t;
+
+typedef struct {
+    const char *uri;
+    httpd_method_t method;
+    esp_err_t (*handler)(httpd_req_t *req);
+    void *user_ctx;
+} httpd_uri_t;
+
+esp_err_t httpd_start(httpd_handle_t *handle, const httpd_config_t *config);
+esp_err_t httpd_stop(httpd_handle_t handle);
+esp_err_t httpd_register_uri_handler(httpd_handle_t handle, const httpd_uri_t *uri);
+
+esp_err_t httpd_req_get_hdr_value_str(httpd_req_t *req, const char *field, char *val, size_t val_size);
+int httpd_req_recv(httpd_req_t *req, char *buf, size_t buf_len);
+esp_err_t httpd_resp_sendstr(httpd_req_t *req, const char *str);
+esp_err_t httpd_resp_send_err(httpd_req_t *req, httpd_err_code_t error, const char *msg);
+
+// Host only: the port the server started last is listening on
+int httpd_host_port(void);
+
+#endif // HOST_ESP_HTTP_SERVER_H
@@ -0,0 +1,58 @@
+#include "freertos/queue.h"
+#include <chrono>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <mutex>
+#include <string>
+
+struct QueueDefinition {
+    UBaseType_t length;
+    UBaseType_t itemSize;
+    std::deque<std::string> items;
+    std::mutex lock;
+    std::condition_variable changed;
+};
+
+// Waits until ready() or wait ticks have gone, with the queue's lock held
+template <class F>
+static bool wait_for(QueueDefinition *q, std::unique_lock<std::mutex> &held, TickType_t wait, F ready)
+{
+    if (wait == portMAX_DELAY)
+    {
+        q->changed.wait(held, ready);
+        return true;
+    }
+    return q->changed.wait_for(held, std::chrono::milliseconds(wait), ready);
+}
+
+QueueHandle_t xQueueCreate(UBaseType_t length, UBaseType_t itemSize)
+{
+    QueueDefinition *q = new QueueDefinition;
+    q->length = length;
+    q->itemSize = itemSize;
+    return q;
+}
+
+BaseType_t xQueueSend(QueueHandle_t q, const void *item, TickType_t wait)
+{
+    std::unique_lock<std::mutex> held(q->lock);
+    if (!wait_for(q, held, wait, [q] { return q->items.size() < q->length; }))
+        return pdFALSE;
+    q->items.emplace_back((const char *)item, q->itemSize);
+    q->changed.notify_all();
+    return pdTRUE;
+}
+
+BaseType_t xQueueReceive(QueueHandle_t q, void *item, TickType_t wait)
+{
+    std::unique_lock<std::mutex> held(q->lock);
+    if (!wait_for(q, held, wait, [q] { return !q->items.empty(); }))
+        return pdFALSE;
+    memcpy(item, q->items.front().data(), q->itemSize);
+    q->items.pop_front();
+    q->changed.notify_all();
+    return pdTRUE;
+}
+
+void vQueueDelete(QueueHandle_t q) { delete q; }
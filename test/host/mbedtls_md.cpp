@@ -0,0 +1,53 @@
+#include "mbedtls/md.h"
+#include <openssl/evp.h>
+#include <openssl/core_names.h>
+#include <openssl/params.h>
+
+struct mbedtls_md_info_t {
+    int unused;
+};
+
+static const mbedtls_md_info_t sha256 = {0};
+
+const mbedtls_md_info_t *mbedtls_md_info_from_type(mbedtls_md_type_t type)
+{
+    return type == MBEDTLS_MD_SHA256 ? &sha256 : nullptr;
+}
+
+void mbedtls_md_init(mbedtls_md_context_t *ctx) { ctx->mac = nullptr; }
+
+void mbedtls_md_free(mbedtls_md_context_t *ctx)
+{
+    EVP_MAC_CTX_free((EVP_MAC_CTX *)ctx->mac);
+    ctx->mac = nullptr;
+}
+
+int mbedtls_md_setup(mbedtls_md_context_t *ctx, const mbedtls_md_info_t *info, int hmac)
+{
+    if (info != &sha256 || !hmac)
+        return -1;
+    EVP_MAC *mac = EVP_MAC_fetch(nullptr, "HMAC", nullptr);
+    ctx->mac = mac ? EVP_MAC_CTX_new(mac) : nullptr;
+    EVP_MAC_free(mac); // The context keeps its own reference
+    return ctx->mac ? 0 : -1;
+}
+
+int mbedtls_md_hmac_starts(mbedtls_md_context_t *ctx, const unsigned char *key, size_t keylen)
+{
+    OSSL_PARAM params[] = {
+        OSSL_PARAM_construct_utf8_string(OSSL_MAC_PARAM_DIGEST, (char *)"SHA256", 0),
+        OSSL_PARAM_construct_end(),
+    };
+    return EVP_MAC_init((EVP_MAC_CTX *)ctx->mac, key, keylen, params) ? 0 : -1;
+}
+
+int mbedtls_md_hmac_update(mbedtls_md_context_t *ctx, const unsigned char *input, size_t ilen)
+{
+    return EVP_MAC_update((EVP_MAC_CTX *)ctx->mac, input, ilen) ? 0 : -1;
+}
+
+int mbedtls_md_hmac_finish(mbedtls_md_context_t *ctx, unsigned char *output)
+{
+    size_t len;
+    return EVP_MAC_final((EVP_MAC_CTX *)ctx->mac, output, &len, 32) ? 0 : -1;
+}
@@ -0,0 +1,48 @@
+#include "rom/miniz.h"
+#include <zlib.h>
+
+void tinfl_init(tinfl_decompressor *r)
+{
+    // Kept for the life of the program, like the decompressor gzip_stream allocates once
+    if (!r->zlib)
+    {
+        r->zlib = new z_stream();
+        inflateInit2((z_stream *)r->zlib, -15);
+    }
+    else
+        inflateReset((z_stream *)r->zlib);
+    r->m_num_bits = 0;
+    r->m_bit_buf = 0;
+}
+
+tinfl_status tinfl_decompress(tinfl_decompressor *r, const uint8_t *pIn_buf_next, size_t *pIn_buf_size,
+                              uint8_t *, uint8_t *pOut_buf_next, size_t *pOut_buf_size, const uint32_t)
+{
+    z_stream *z = (z_stream *)r->zlib;
+    z->next_in = (Bytef *)pIn_buf_next;
+    z->avail_in = *pIn_buf_size;
+    z->next_out = pOut_buf_next;
+    z->avail_out = *pOut_buf_size;
+    int ret = inflate(z, Z_NO_FLUSH);
+    *pOut_buf_size -= z->avail_out;
+
+    if (ret == Z_STREAM_END)
+    {
+        // zlib stops on the last deflate byte; tinfl's bit buffer would have the next few as well. The
+        // padding bits are set so they can't be mistaken for the data.
+        uint32_t padding = z->data_type & 7;
+        uint32_t ahead = z->avail_in < 3 ? z->avail_in : 3;
+        r->m_bit_buf = (1u << padding) - 1;
+        for (uint32_t i = 0; i < ahead; i++)
+            r->m_bit_buf |= (tinfl_bit_buf_t)z->next_in[i] << (padding + 8 * i);
+        r->m_num_bits = padding + 8 * ahead;
+        z->avail_in -= ahead;
+    }
+    *pIn_buf_size -= z->avail_in;
+
+    if (ret == Z_STREAM_END)
+        return TINFL_STATUS_DONE;
+    if (ret != Z_OK && ret != Z_BUF_ERROR)
+        return TINFL_STATUS_FAILED;
+    return z->avail_out == 0 ? TINFL_STATUS_HAS_MORE_OUTPUT : TINFL_STATUS_NEEDS_MORE_INPUT;
+}
@@ -0,0 +1,41 @@
+#include "nvs.h"
+#include <map>
+#include <string>
+#include <cstring>
+
+static std::map<std::string, std::string> blobs; // namespace/key -> value
+static std::map<nvs_handle_t, std::string> open_namespaces;
+static nvs_handle_t next_handle = 1;
+static int writes = 0;
+
+esp_err_t nvs_open(const char *name, nvs_open_mode_t, nvs_handle_t *handle)
+{
+    *handle = next_handle++;
+    open_namespaces[*handle] = name;
+    return ESP_OK;
+}
+
+esp_err_t nvs_get_blob(nvs_handle_t handle, const char *key, void *value, size_t *length)
+{
+    auto it = blobs.find(open_namespaces[handle] + "/" + key);
+    if (it == blobs.end())
+        return ESP_ERR_NVS_NOT_FOUND;
+    if (*length < it->second.size())
+        return ESP_FAIL;
+    memcpy(value, it->second.data(), it->second.size());
+    *length = it->second.size();
+    return ESP_OK;
+}
+
+esp_err_t nvs_set_blob(nvs_handle_t handle, const char *key, const void *value, size_t length)
+{
+    blobs[open_namespaces[handle] + "/" + key] = std::string((const char *)value, length);
+    writes++;
+    return ESP_OK;
+}
+
+esp_err_t nvs_commit(nvs_handle_t) { return ESP_OK; }
+
+void nvs_close(nvs_handle_t handle) { open_namespaces.erase(handle); }
+
+int nvs_host_writes() { return writes; }
@@ -0,0 +1,22 @@
+#ifndef HOST_NVS_H
+#define HOST_NVS_H
+
+#include <stddef.h>
+#include "esp_err.h"
+
+// Host stand-in for NVS: blobs kept in memory for as long as the test runs, so an HttpCacheEntry made
+// later sees what an earlier one saved (i.e. a reboot)
+
+typedef unsigned nvs_handle_t;
+typedef enum { NVS_READONLY, NVS_READWRITE } nvs_open_mode_t;
+
+esp_err_t nvs_open(const char *name, nvs_open_mode_t mode, nvs_handle_t *handle);
+esp_err_t nvs_get_blob(nvs_handle_t handle, const char *key, void *value, size_t *length);
+esp_err_t nvs_set_blob(nvs_handle_t handle, const char *key, const void *value, size_t length);
+esp_err_t nvs_commit(nvs_handle_t handle);
+void nvs_close(nvs_handle_t handle);
+
+// Host only: blob writes so far, to check flash is only written when something changed
+int nvs_host_writes();
+
+#endif // HOST_NVS_H
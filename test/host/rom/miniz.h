@@ -0,0 +1,39 @@
+#ifndef HOST_ROM_MINIZ_H
+#define HOST_ROM_MINIZ_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+// Host stand-in for the tinfl decompressor in the S3's ROM, on zlib's raw inflate (link -lz). Same calls,
+// status codes and wrapping 32 KB window.
+//
+// It also reads ahead the way tinfl does: the call that finishes the deflate data swallows up to 3 more bytes
+// of the input into m_bit_buf / m_num_bits, above the padding bits of the last deflate byte, and counts them
+// as used. Whatever comes after the deflate data has to be picked up from there, as on the device.
+
+#define TINFL_LZ_DICT_SIZE 32768
+#define TINFL_FLAG_HAS_MORE_INPUT 2
+
+typedef enum {
+    TINFL_STATUS_BAD_PARAM = -3,
+    TINFL_STATUS_ADLER32_MISMATCH = -2,
+    TINFL_STATUS_FAILED = -1,
+    TINFL_STATUS_DONE = 0,
+    TINFL_STATUS_NEEDS_MORE_INPUT = 1,
+    TINFL_STATUS_HAS_MORE_OUTPUT = 2
+} tinfl_status;
+
+typedef uint32_t tinfl_bit_buf_t; // 32 bit on Xtensa
+
+typedef struct {
+    uint32_t m_num_bits;
+    tinfl_bit_buf_t m_bit_buf;
+    void *zlib; // z_stream
+} tinfl_decompressor;
+
+void tinfl_init(tinfl_decompressor *r);
+tinfl_status tinfl_decompress(tinfl_decompressor *r, const uint8_t *pIn_buf_next, size_t *pIn_buf_size,
+                              uint8_t *pOut_buf_start, uint8_t *pOut_buf_next, size_t *pOut_buf_size,
+                              const uint32_t decomp_flags);
+
+#endif // HOST_ROM_MINIZ_H
@@ -0,0 +1,315 @@
+#include <iostream>
+#include <string>
+#include <thread>
+#include <mutex>
+#include <cstring>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <unistd.h>
+
+#include "http_cache.h"
+#include "json_stream.h"
+#include "nvs.h"
+
+// HttpCacheEntry (main/http_cache.h) against a stand-in for TBA: a local HTTP server that answers If-None-Match and
+// If-Modified-Since like the real one. Requests go through host/esp_http_client (a socket client giving the same
+// events as on the device) and the validators through host/nvs, and the requests are made the way tba_network makes
+// them. Checks the first fetch, the 304s after it, a changed resource, a reboot (with and without the data being
+// restored, and with a snapshot older than the saved validators), a changed URL, an ETag too long to keep, a
+// Last-Modified only server and a client shared between URLs.
+//
+// g++ -Ihost -I../main -o http_cache_test.exe http_cache_test.cpp ../main/http_cache.cpp ../main/json_stream.cpp
+//     host/esp_http_client.cpp host/nvs.cpp -pthread
+
+// --- Stand-in server ---
+class StandIn
+{
+public:
+    // What it serves
+    std::string body = "[{\"match_number\":1,\"alliances\":{\"red\":{\"score\":120}}}]";
+    std::string etag = "W/\"5459-1\"";
+    std::string lastModified = "Sat, 21 Mar 2026 14:00:00 GMT";
+
+    // What the last request sent, "" if nothing
+    std::string ifNoneMatch, ifModifiedSince;
+    int requests = 0;
+
+    int port = 0;
+
+    StandIn()
+    {
+        listener = socket(AF_INET, SOCK_STREAM, 0);
+        sockaddr_in addr = {};
+        addr.sin_family = AF_INET;
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        bind(listener, (sockaddr *)&addr, sizeof(addr)); // Any free port
+        socklen_t len = sizeof(addr);
+        getsockname(listener, (sockaddr *)&addr, &len);
+        port = ntohs(addr.sin_port);
+        listen(listener, 4);
+        thread = std::thread([this] { serve(); });
+    }
+
+    ~StandIn()
+    {
+        shutdown(listener, SHUT_RDWR);
+        close(listener);
+        thread.join();
+    }
+
+    std::string url(const char *path) const { return "http://127.0.0.1:" + std::to_string(port) + path; }
+
+    std::mutex lock;
+
+private:
+    int listener;
+    std::thread thread;
+
+    static std::string header(const std::string &request, const char *name)
+    {
+        std::string key = std::string("\r\n") + name + ": ";
+        size_t at = request.find(key);
+        if (at == std::string::npos)
+            return "";
+        at += key.size();
+        return request.substr(at, request.find("\r\n", at) - at);
+    }
+
+    void serve()
+    {
+        int s;
+        while ((s = accept(listener, nullptr, nullptr)) >= 0)
+        {
+            std::string request;
+            char buf[1024];
+            ssize_t n;
+            while (request.find("\r\n\r\n") == std::string::npos && (n = read(s, buf, sizeof(buf))) > 0)
+                request.append(buf, n);
+
+            std::lock_guard<std::mutex> guard(lock);
+            requests++;
+            ifNoneMatch = header(request, "If-None-Match");
+            ifModifiedSince = header(request, "If-Modified-Since");
+
+            // If-None-Match wins when both are sent (RFC 9110 13.2.2)
+            bool notModified = !ifNoneMatch.empty() ? (!etag.empty() && ifNoneMatch == etag)
+                                                    : (!ifModifiedSince.empty() && ifModifiedSince == lastModified);
+
+            std::string response = notModified ? "HTTP/1.1 304 Not Modified\r\n" : "HTTP/1.1 200 OK\r\n";
+            if (!etag.empty())
+                response += "ETag: " + etag + "\r\n";
+            if (!lastModified.empty())
+                response += "Last-Modified: " + lastModified + "\r\n";
+            if (!notModified)
+                response += "Content-Length: " + std::to_string(body.size()) + "\r\n\r\n" + body;
+            else
+                response += "\r\n";
+            if (write(s, response.data(), response.size()) < 0)
+                std::cout << "stand-in: write failed" << std::endl;
+            close(s);
+        }
+    }
+};
+
+// --- As tba_network fetches ---
+class Scores : public JsonListener
+{
+public:
+    int scores = 0;
+    void onJson(const JsonStream &json, JsonEvent event, const char *) override
+    {
+        if (event == JSON_NUMBER && strcmp(json.key(), "score") == 0)
+            scores++;
+    }
+};
+
+struct Fetch
+{
+    HttpCacheEntry *cache;
+    JsonStream *json;
+};
+
+static esp_err_t on_event(esp_http_client_event_t *evt)
+{
+    Fetch *f = (Fetch *)evt->user_data;
+    if (evt->event_id == HTTP_EVENT_ON_HEADER)
+        f->cache->onHeader(evt->header_key, evt->header_value);
+    else if (evt->event_id == HTTP_EVENT_ON_DATA && esp_http_client_get_status_code(evt->client) == 200)
+        f->json->feed((const char *)evt->data, evt->data_len);
+    return ESP_OK;
+}
+
+enum Outcome { FRESH, NOT_MODIFIED, FAILED };
+
+// One request, on client if given (shared between URLs like tbaClient) or a new one
+static Outcome get(HttpCacheEntry &cache, int *parsed = nullptr, esp_http_client_handle_t client = nullptr)
+{
+    Scores scores;
+    JsonStream json(&scores);
+    Fetch fetch = {&cache, &json};
+
+    bool own = client == nullptr;
+    if (own)
+    {
+        esp_http_client_config_t config = {};
+        config.url = cache.url;
+        config.event_handler = on_event;
+        client = esp_http_client_init(&config);
+    }
+    esp_http_client_set_url(client, cache.url);
+    esp_http_client_set_user_data(client, &fetch);
+
+    cache.begin(client);
+    esp_err_t err = esp_http_client_perform(client);
+    int status = esp_http_client_get_status_code(client);
+    if (own)
+        esp_http_client_cleanup(client);
+
+    if (parsed)
+        *parsed = scores.scores;
+    if (err == ESP_OK && status == 304)
+    {
+        cache.notModified();
+        return NOT_MODIFIED;
+    }
+    if (err == ESP_OK && status == 200 && json.finish())
+    {
+        cache.used(json.bytesFed(), 100);
+        return FRESH;
+    }
+    return FAILED;
+}
+
+static int failures = 0;
+
+static void check(bool ok, const char *what)
+{
+    std::cout << (ok ? "  ok    " : "  FAIL  ") << what << std::endl;
+    if (!ok)
+        failures++;
+}
+
+int main()
+{
+    StandIn tba;
+    std::string matchesUrl = tba.url("/api/v3/team/frc5459/event/2026mabos/matches/simple");
+    std::string eventsUrl = tba.url("/api/v3/team/frc5459/events/2026/simple");
+    int parsed = 0;
+    uint32_t oldSnapshot = 0, snapshot = 0; // validatorsHash() saved with the data, as tba_network does
+
+    std::cout << "First boot" << std::endl;
+    {
+        HttpCacheEntry matches("matches", matchesUrl.c_str());
+        matches.load();
+        check(matches.validatorsHash() == 0, "nothing held, nothing to save a snapshot with");
+
+        check(get(matches, &parsed) == FRESH && parsed == 1, "first fetch is a 200, parsed");
+        check(tba.ifNoneMatch.empty() && tba.ifModifiedSince.empty(), "first fetch isn't conditional");
+        check(matches.haveData, "haveData once parsed");
+        check(nvs_host_writes() == 1, "validators written to NVS");
+        oldSnapshot = matches.validatorsHash();
+        check(oldSnapshot != 0, "snapshot saved with the validators' hash");
+
+        check(get(matches, &parsed) == NOT_MODIFIED && parsed == 0, "second fetch is a 304, nothing parsed");
+        check(tba.ifNoneMatch == tba.etag && tba.ifModifiedSince == tba.lastModified, "sends If-None-Match and If-Modified-Since");
+        check(get(matches) == NOT_MODIFIED && nvs_host_writes() == 1, "304s don't write NVS");
+
+        tba.etag = "W/\"5459-2\"";
+        tba.lastModified = "Sat, 21 Mar 2026 14:07:00 GMT";
+        tba.body = "[{\"match_number\":1,\"alliances\":{\"red\":{\"score\":120}}},{\"match_number\":2,\"alliances\":{\"red\":{\"score\":95}}}]";
+        check(get(matches, &parsed) == FRESH && parsed == 2, "changed resource is a 200 with the new body");
+        check(nvs_host_writes() == 2, "new validators written");
+        check(get(matches) == NOT_MODIFIED && tba.ifNoneMatch == tba.etag, "then 304s on the new ETag");
+        snapshot = matches.validatorsHash();
+        check(snapshot != 0 && snapshot != oldSnapshot, "new snapshot, new hash");
+        matches.report();
+    }
+
+    std::cout << "Reboot, nothing restored" << std::endl;
+    {
+        HttpCacheEntry matches("matches", matchesUrl.c_str());
+        matches.load();
+        check(!matches.haveData, "no data yet");
+        check(get(matches, &parsed) == FRESH && parsed == 2, "fetch isn't conditional, so the data comes back");
+        check(tba.ifNoneMatch.empty(), "no If-None-Match sent");
+        check(nvs_host_writes() == 2, "same validators aren't written again");
+        check(get(matches) == NOT_MODIFIED, "then 304s");
+    }
+
+    std::cout << "Reboot, data restored (tba_restore_snapshot)" << std::endl;
+    {
+        HttpCacheEntry matches("matches", matchesUrl.c_str());
+        matches.load();
+        matches.restored(snapshot);
+        check(matches.haveData, "snapshot matches the saved validators");
+        check(get(matches, &parsed) == NOT_MODIFIED && parsed == 0, "first fetch after the reboot is already a 304");
+        check(tba.ifNoneMatch == tba.etag, "validators from before the reboot sent");
+    }
+
+    std::cout << "Reboot, snapshot older than the saved validators" << std::endl;
+    {
+        // Power went after NVS took the new validators but before the snapshot with their data was written
+        HttpCacheEntry matches("matches", matchesUrl.c_str());
+        matches.load();
+        matches.restored(oldSnapshot);
+        check(!matches.haveData, "not held");
+        check(get(matches, &parsed) == FRESH && parsed == 2 && tba.ifNoneMatch.empty(),
+              "fetch isn't conditional, so the current data comes back");
+        matches.restored(0);
+        check(!matches.haveData, "a snapshot without this part isn't held either");
+    }
+
+    std::cout << "URL changed under the saved entry" << std::endl;
+    {
+        std::string otherUrl = tba.url("/api/v3/team/frc5459/event/2026nhdur/matches/simple");
+        HttpCacheEntry matches("matches", otherUrl.c_str());
+        matches.load();
+        matches.haveData = true; // Even so, nothing saved is for this URL
+        check(get(matches) == FRESH && tba.ifNoneMatch.empty() && tba.ifModifiedSince.empty(), "old validators dropped");
+    }
+
+    std::cout << "ETag too long to keep" << std::endl;
+    {
+        tba.etag = "\"" + std::string(HTTP_CACHE_ETAG_MAX, 'e') + "\"";
+        tba.lastModified = "";
+        HttpCacheEntry events("events", eventsUrl.c_str());
+        check(get(events) == FRESH && get(events) == FRESH, "never conditional, every fetch a 200");
+        check(tba.ifNoneMatch.empty(), "oversized ETag not sent back");
+    }
+
+    std::cout << "Last-Modified only" << std::endl;
+    {
+        tba.etag = "";
+        tba.lastModified = "Sun, 22 Mar 2026 09:00:00 GMT";
+        HttpCacheEntry events("events", eventsUrl.c_str());
+        events.load();
+        check(get(events) == FRESH, "200");
+        check(get(events) == NOT_MODIFIED && tba.ifNoneMatch.empty() && tba.ifModifiedSince == tba.lastModified, "304 on If-Modified-Since alone");
+    }
+
+    std::cout << "One client for both URLs" << std::endl;
+    {
+        tba.etag = "W/\"5459-3\"";
+        HttpCacheEntry matches("matches", matchesUrl.c_str());
+        std::string statusUrl = tba.url("/api/v3/status");
+        HttpCacheEntry status("status", statusUrl.c_str());
+        matches.load();
+        esp_http_client_config_t config = {};
+        config.url = matchesUrl.c_str();
+        config.event_handler = on_event;
+        esp_http_client_handle_t client = esp_http_client_init(&config);
+
+        get(matches, nullptr, client);
+        matches.haveData = true;
+        get(matches, nullptr, client);
+        check(!tba.ifNoneMatch.empty(), "matches request conditional");
+
+        get(status, nullptr, client);
+        check(tba.ifNoneMatch.empty() && tba.ifModifiedSince.empty(), "next URL's request doesn't carry them");
+        esp_http_client_cleanup(client);
+    }
+
+    std::cout << tba.requests << " requests served" << std::endl;
+    std::cout << (failures ? "FAILED" : "PASSED") << std::endl;
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,323 @@
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+
+#include "json_stream.h"
+
+#ifdef WITH_CJSON
+#include "cJSON.h"
+#endif
+
+// JsonStream (main/json_stream.h) on TBA shaped payloads (tba_payloads/): event counts and the fields tba_network
+// pulls out, the same events whether the body comes whole, a byte at a time or in random pieces, the edge cases
+// (tokens past JSON_MAX_TOKEN, nesting past JSON_MAX_DEPTH, escapes, bad documents), then parse time and memory.
+// Built with WITH_CJSON the same payloads go through cJSON (as tba_network used to) for comparison.
+//
+// g++ -O2 -I../main -o json_stream_test.exe json_stream_test.cpp ../main/json_stream.cpp
+// g++ -O2 -DWITH_CJSON -I../main -I$IDF_PATH/components/json/cJSON -o json_stream_test.exe json_stream_test.cpp
+//     ../main/json_stream.cpp $IDF_PATH/components/json/cJSON/cJSON.c
+
+static int failures = 0;
+
+static void check(bool ok, const std::string &what)
+{
+    if (!ok)
+    {
+        std::cout << "FAIL: " << what << std::endl;
+        failures++;
+    }
+}
+
+// Every event with its full path, so two parses can be compared
+class Recorder : public JsonListener
+{
+public:
+    std::string log;
+    int counts[JSON_NULL + 1] = {};
+
+    void onJson(const JsonStream &json, JsonEvent event, const char *value) override
+    {
+        counts[event]++;
+        log += std::to_string(event);
+        for (int i = 1; i <= json.depth(); i++)
+            log += "/" + (json.key(i)[0] ? std::string(json.key(i)) : std::to_string(json.index(i)));
+        log += value ? "=" + std::string(value) : "";
+        log += "\n";
+    }
+};
+
+// What tba_network's listeners keep: match_number and red score, event start_date and city, team number and nickname
+class Fields : public JsonListener
+{
+public:
+    std::vector<std::pair<int, int>> matches;
+    std::vector<std::string> events;
+    int teamNumber = 0;
+    std::string nickname;
+
+    void onJson(const JsonStream &json, JsonEvent event, const char *value) override
+    {
+        int depth = json.depth();
+        if (depth == 1 && event == JSON_OBJECT_START)
+        {
+            matchNumber = 0;
+            redScore = -1;
+            date.clear();
+            city.clear();
+        }
+        else if (depth == 1 && event == JSON_NUMBER && strcmp(json.key(), "team_number") == 0)
+            teamNumber = atoi(value);
+        else if (depth == 1 && event == JSON_STRING && strcmp(json.key(), "nickname") == 0)
+            nickname = value;
+        else if (depth == 2 && event == JSON_NUMBER && strcmp(json.key(), "match_number") == 0)
+            matchNumber = atoi(value);
+        else if (depth == 2 && event == JSON_STRING && strcmp(json.key(), "start_date") == 0)
+            date = value;
+        else if (depth == 2 && event == JSON_STRING && strcmp(json.key(), "city") == 0)
+            city = value;
+        else if (depth == 4 && event == JSON_NUMBER && strcmp(json.key(), "score") == 0 && strcmp(json.key(3), "red") == 0 &&
+                 strcmp(json.key(2), "alliances") == 0)
+            redScore = atoi(value);
+        else if (depth == 1 && event == JSON_OBJECT_END)
+        {
+            if (redScore >= 0 && json.index(1) < 12)
+                matches.push_back({matchNumber, redScore});
+            if (!date.empty())
+                events.push_back(date + " " + city);
+        }
+    }
+
+private:
+    int matchNumber = 0;
+    int redScore = -1;
+    std::string date, city;
+};
+
+static std::string load(const std::string &name)
+{
+    std::ifstream in("tba_payloads/" + name, std::ios::binary);
+    std::stringstream s;
+    s << in.rdbuf();
+    if (!in)
+        check(false, "couldn't read tba_payloads/" + name + " (run from test/)");
+    return s.str();
+}
+
+// Feed in pieces of the given sizes (repeating), true if it parsed as one document
+static bool parse(const std::string &doc, JsonListener *listener, const std::vector<int> &sizes)
+{
+    JsonStream json(listener);
+    size_t at = 0;
+    for (size_t i = 0; at < doc.size(); i++)
+    {
+        int n = std::min((size_t)sizes[i % sizes.size()], doc.size() - at);
+        json.feed(doc.data() + at, n);
+        at += n;
+    }
+    return json.finish();
+}
+
+static std::vector<int> random_sizes(int max)
+{
+    std::vector<int> sizes;
+    for (int i = 0; i < 997; i++)
+        sizes.push_back(1 + rand() % max);
+    return sizes;
+}
+
+struct Expected
+{
+    const char *file;
+    int objects, arrays, strings, numbers, nulls;
+};
+
+static void payload(const Expected &e, Fields &fields)
+{
+    std::string doc = load(e.file);
+    Recorder whole;
+    check(parse(doc, &whole, {(int)doc.size()}), std::string(e.file) + " didn't parse");
+    check(whole.counts[JSON_OBJECT_START] == e.objects && whole.counts[JSON_OBJECT_END] == e.objects, std::string(e.file) + " objects");
+    check(whole.counts[JSON_ARRAY_START] == e.arrays && whole.counts[JSON_ARRAY_END] == e.arrays, std::string(e.file) + " arrays");
+    check(whole.counts[JSON_STRING] == e.strings, std::string(e.file) + " strings " + std::to_string(whole.counts[JSON_STRING]));
+    check(whole.counts[JSON_NUMBER] == e.numbers, std::string(e.file) + " numbers " + std::to_string(whole.counts[JSON_NUMBER]));
+    check(whole.counts[JSON_NULL] == e.nulls, std::string(e.file) + " nulls");
+
+    for (const std::vector<int> &sizes : {std::vector<int>{1}, std::vector<int>{7}, std::vector<int>{2048}, random_sizes(64), random_sizes(1500)})
+    {
+        Recorder pieces;
+        parse(doc, &pieces, sizes);
+        check(pieces.log == whole.log, std::string(e.file) + " differs fed in pieces of " + std::to_string(sizes[0]) + (sizes.size() > 1 ? " ..." : ""));
+    }
+
+    parse(doc, &fields, {2048});
+    std::cout << std::left << std::setw(20) << e.file << std::setw(7) << doc.size() << "bytes, "
+              << whole.counts[JSON_OBJECT_START] + whole.counts[JSON_ARRAY_START] + whole.counts[JSON_STRING] + whole.counts[JSON_NUMBER] + whole.counts[JSON_NULL]
+              << " values" << std::endl;
+}
+
+// A small document fed whole, then split in two at every point, must give log (and succeed or fail) the same way
+static void edge(const char *what, const std::string &doc, bool ok, const std::string &log = "")
+{
+    Recorder whole;
+    bool parsed = parse(doc, &whole, {(int)doc.size()});
+    check(parsed == ok, std::string(what) + (ok ? " didn't parse" : " parsed"));
+    if (ok && !log.empty())
+        check(whole.log == log, std::string(what) + " gave\n" + whole.log);
+
+    for (size_t split = 1; split < doc.size(); split++)
+    {
+        Recorder two;
+        JsonStream json(&two);
+        json.feed(doc.data(), split);
+        json.feed(doc.data() + split, doc.size() - split);
+        if (json.finish() != parsed || two.log != whole.log)
+        {
+            check(false, std::string(what) + " split at " + std::to_string(split));
+            break;
+        }
+    }
+}
+
+static void edges()
+{
+    std::string longString(100, 's');
+    edge("100 character string", "[\"" + longString + "\"]", true, "2\n4/0=" + longString.substr(0, JSON_MAX_TOKEN - 1) + "\n3\n");
+    edge("64 character string", "[\"" + std::string(64, 's') + "\"]", true, "2\n4/0=" + std::string(JSON_MAX_TOKEN - 1, 's') + "\n3\n");
+    edge("63 character string", "[\"" + std::string(63, 's') + "\"]", true, "2\n4/0=" + std::string(63, 's') + "\n3\n");
+    std::string longNumber(80, '7');
+    edge("80 digit number", "[" + longNumber + ",1]", true, "2\n5/0=" + longNumber.substr(0, JSON_MAX_TOKEN - 1) + "\n5/1=1\n3\n");
+    std::string longKey(40, 'k');
+    edge("40 character key", "{\"" + longKey + "\":1}", true, "0\n5/" + longKey.substr(0, JSON_MAX_KEY - 1) + "=1\n1\n");
+
+    std::string deepest = std::string(JSON_MAX_DEPTH, '[') + std::string(JSON_MAX_DEPTH, ']');
+    edge("nesting at JSON_MAX_DEPTH", deepest, true);
+    edge("nesting past JSON_MAX_DEPTH", "[" + deepest + "]", false);
+    std::string objects;
+    for (int i = 0; i <= JSON_MAX_DEPTH; i++)
+        objects += "{\"a\":";
+    edge("objects past JSON_MAX_DEPTH", objects + "1" + std::string(JSON_MAX_DEPTH + 1, '}'), false);
+
+    edge("escapes", "[\"q\\\"b\\\\s\\/b\\bf\\fn\\nr\\rt\\t\"]", true, "2\n4/0=q\"b\\s/b\bf\fn\nr\rt\t\n3\n");
+    edge("\\u escapes", "[\"\\u0041\\u00e9\\u20AC\\ud83d\"]", true, "2\n4/0=A\xC3\xA9\xE2\x82\xAC?\n3\n");
+    edge("raw UTF-8", "[\"\xE2\x80\x93\"]", true, "2\n4/0=\xE2\x80\x93\n3\n");
+    edge("bad escape", "[\"\\x\"]", false);
+    edge("bad \\u digit", "[\"\\u00g0\"]", false);
+
+    edge("literals", " [true, false, null, -2.5e3, 0] ", true, "2\n6/0=true\n6/1=false\n7/2=null\n5/3=-2.5e3\n5/4=0\n3\n");
+    edge("empty containers", "{\"a\":{},\"b\":[]}", true, "0\n0/a\n1/a\n2/b\n3/b\n1\n");
+    edge("bare number document", "42", true, "5=42\n");
+    edge("bare string document", "\"x\"", true, "4=x\n");
+    edge("trailing comma", "[1,]", false);
+    edge("missing colon", "{\"a\" 1}", false);
+    edge("missing comma", "[1 2]", false);
+    edge("extra close", "{\"a\":1}}", false);
+    edge("mismatched close", "[1}", false);
+    edge("bad literal", "[tru]", false);
+    edge("unfinished", "[", false);
+    edge("two documents", "[] []", false);
+}
+
+// --- Timing ---
+static double us_per_parse(const std::string &doc, int chunk)
+{
+    const int runs = 200;
+    Fields fields;
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < runs; i++)
+        parse(doc, &fields, {chunk});
+    return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count() / runs;
+}
+
+#ifdef WITH_CJSON
+static size_t heapNow = 0, heapPeak = 0;
+
+static void *counting_malloc(size_t n)
+{
+    size_t *p = (size_t *)malloc(n + sizeof(size_t));
+    *p = n;
+    heapNow += n;
+    heapPeak = std::max(heapPeak, heapNow);
+    return p + 1;
+}
+
+static void counting_free(void *ptr)
+{
+    if (!ptr)
+        return;
+    size_t *p = (size_t *)ptr - 1;
+    heapNow -= *p;
+    free(p);
+}
+
+// As parse_tba_json did: whole body in memory, DOM, pull out the scores, delete
+static int cjson_scores(const std::string &doc)
+{
+    int sum = 0;
+    cJSON *root = cJSON_Parse(doc.c_str());
+    cJSON *match;
+    cJSON_ArrayForEach(match, root)
+    {
+        cJSON *alliances = cJSON_GetObjectItemCaseSensitive(match, "alliances");
+        cJSON *red = cJSON_GetObjectItemCaseSensitive(alliances, "red");
+        cJSON *score = cJSON_GetObjectItemCaseSensitive(red, "score");
+        if (cJSON_IsNumber(score))
+            sum += score->valueint;
+    }
+    cJSON_Delete(root);
+    return sum;
+}
+#endif
+
+static void timings(const char *file)
+{
+    std::string doc = load(file);
+    std::cout << std::left << std::setw(20) << file << std::fixed << std::setprecision(1)
+              << "JsonStream " << std::setw(7) << us_per_parse(doc, 2048) << "us, " << sizeof(JsonStream) << " bytes + a 2048 byte receive buffer";
+
+#ifdef WITH_CJSON
+    cJSON_Hooks hooks = {counting_malloc, counting_free};
+    cJSON_InitHooks(&hooks);
+    heapNow = heapPeak = 0;
+    cjson_scores(doc);
+    size_t domPeak = heapPeak;
+
+    const int runs = 200;
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < runs; i++)
+        cjson_scores(doc);
+    double us = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count() / runs;
+    std::cout << "   cJSON " << std::setw(7) << us << "us, " << doc.size() + domPeak << " bytes (body + DOM)";
+#endif
+    std::cout << std::endl;
+}
+
+int main()
+{
+    srand(5459);
+
+    Fields events, teamMatches, eventMatches, team;
+    payload({"events.json", 7, 1, 41, 11, 1}, events);
+    payload({"team_matches.json", 56, 85, 140, 96, 2}, teamMatches);
+    payload({"event_matches.json", 396, 595, 990, 664, 29}, eventMatches);
+    payload({"team.json", 1, 0, 6, 1, 0}, team);
+
+    check(events.events == std::vector<std::string>{"2026-03-20 Boston", "2026-04-03 Durham", "2026-04-15 West Springfield", "2026-03-06 Worcester"}, "event dates and cities");
+    check(teamMatches.matches == std::vector<std::pair<int, int>>{{3, 161}, {9, 87}, {15, 113}, {21, 181}, {27, 83}, {33, 146}, {39, 81}, {45, 176}, {51, 141}, {57, 115}, {63, 147}, {69, 132}}, "team match scores");
+    check(eventMatches.matches.size() == 12 && eventMatches.matches[0] == std::make_pair(1, 122) && eventMatches.matches[11] == std::make_pair(12, 67), "event match scores");
+    check(team.teamNumber == 5459 && team.nickname == "Ipswich TIGERS", "team number and nickname");
+
+    edges();
+
+    std::cout << std::endl << "Parse time (host, -O2), memory:" << std::endl;
+    for (const char *file : {"events.json", "team_matches.json", "event_matches.json"})
+        timings(file);
+
+    std::cout << (failures ? "FAILED" : "PASSED") << std::endl;
+    return failures ? 1 : 0;
+}
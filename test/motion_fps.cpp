@@ -0,0 +1,91 @@
+#include <iostream>
+#include <cstdint>
+
+#include "animation.h"
+
+// Motion (main/animation.h) lands on the same sub-pixel whatever the frame rate: every speed is run at 20, 40
+// and 60fps, and with a frame held up half a second, and the positions compared every 50ms (a frame boundary
+// at all three rates) against one advance() over the whole time.
+//
+// g++ -I../main -o motion_fps.exe motion_fps.cpp
+
+static const uint32_t RUN_MS = 6000;
+static const uint32_t CHECK_MS = 50;
+
+// Frame times as matrix_task sees them: whole milliseconds of esp_timer, so 60fps is 16, 17, 17, ...
+static uint32_t frame_time(int fps, int frame, bool stall)
+{
+    uint32_t t = (uint32_t)((int64_t)frame * 1000 / fps);
+    if (stall && t > 1000)
+        t += 500; // e.g. a TLS handshake on the same core
+    return t;
+}
+
+int main()
+{
+    const struct { const char *name; int32_t speed; } speeds[] = {
+        {"SPONSOR_SPEED", SPONSOR_SPEED},     {"ZOOM_SPEED", ZOOM_SPEED},   {"PAC_SPEED", PAC_SPEED},
+        {"PAC_POWER_SPEED", PAC_POWER_SPEED}, {"GHOST_SPEED", GHOST_SPEED}, {"GHOST_SCARED_SPEED", GHOST_SCARED_SPEED},
+        {"EYES_SPEED", EYES_SPEED},           {"1/256 px/s", 1},           {"odd", 12345},
+    };
+    int failures = 0;
+    int checks = 0;
+
+    for (const auto &s : speeds)
+    {
+        for (int32_t speed : {s.speed, -s.speed})
+        {
+            for (bool stall : {false, true})
+            {
+                for (int fps : {20, 40, 60})
+                {
+                    Motion m(ANIM_FIX(128));
+                    uint32_t last = 0;
+
+                    for (int frame = 1;; frame++)
+                    {
+                        uint32_t now = frame_time(fps, frame, stall);
+                        if (now > RUN_MS + 500)
+                            break;
+                        m.advance(speed, now - last);
+                        last = now;
+
+                        if (now % CHECK_MS != 0)
+                            continue;
+
+                        Motion once(ANIM_FIX(128));
+                        once.advance(speed, now);
+                        checks++;
+                        if (m.fix() != once.fix() || m.pixel() != once.pixel())
+                        {
+                            std::cout << "FAIL: " << s.name << (speed < 0 ? " backwards" : "") << " at " << fps << "fps"
+                                      << (stall ? " with a stall" : "") << ", " << now << "ms: " << m.fix()
+                                      << " instead of " << once.fix() << std::endl;
+                            failures++;
+                            break;
+                        }
+                    }
+                }
+            }
+        }
+        std::cout << std::left;
+        std::cout.width(20);
+        std::cout << s.name << "after " << RUN_MS << "ms at 20/40/60fps: ";
+        Motion m(ANIM_FIX(128));
+        m.advance(s.speed, RUN_MS);
+        std::cout << m.fix() << " (" << m.pixel() << "px)" << std::endl;
+    }
+
+    // Whole pixels round down, negative positions included (scrolling off the top or left relies on it)
+    Motion neg(ANIM_FIX(0));
+    neg.advance(-1, 1000);
+    if (neg.pixel() != -1)
+    {
+        std::cout << "FAIL: 1/256 px left of 0 is pixel " << neg.pixel() << std::endl;
+        failures++;
+    }
+
+    std::cout << checks << " positions compared" << std::endl;
+    std::cout << (failures ? "FAILED" : "PASSED") << std::endl;
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,197 @@
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <cstdint>
+#include <cstring>
+#include <string>
+
+#include "poll_schedule.h"
+#include "tba_matches.h"
+
+// nextPoll() (main/poll_schedule.h) on synthetic schedules: the windows around our matches, the field's distance
+// from our next match, waking up in time for one, events on / coming / over, no schedule, an unsynced clock, and
+// the backoff steps with their jitter after failures. Then the schedule MatchListener (main/tba_matches.h) makes of
+// tba_payloads/team_matches.json and a few made up matches, and how that polls. Run from this directory.
+//
+// g++ -I../main -o poll_schedule_test.exe poll_schedule_test.cpp ../main/poll_schedule.cpp ../main/tba_matches.cpp
+//     ../main/json_stream.cpp
+
+static const time_t NOW = 1774100000; // Saturday 21 March 2026, mid morning
+static const time_t DAY = 24 * 60 * 60;
+
+static int failures = 0;
+
+static void expect(const char *what, const DisplayModel &model, time_t now, uint32_t expectedMs)
+{
+    PollDecision p = nextPoll(model, now, 0, 0);
+    bool ok = p.delayMs == expectedMs;
+    std::cout << (ok ? "  ok    " : "  FAIL  ") << what << ": " << p.delayMs << "ms, " << p.reason << std::endl;
+    if (!ok)
+        failures++;
+}
+
+// Our next three qualification matches, 0 for one not scheduled
+static DisplayModel schedule(time_t t0, time_t t1, time_t t2, int playing = 0)
+{
+    DisplayModel m = {};
+    const time_t times[3] = {t0, t1, t2};
+    for (int i = 0; i < 3; i++)
+        m.schedule[i] = {'Q', times[i] ? 10 * (i + 1) : 0, 0xF800, times[i]};
+    m.currentlyPlaying = playing;
+    m.nextEventDate = NOW - 9 * 60 * 60; // Today's the first day
+    m.nextEventEnd = NOW + DAY;
+    return m;
+}
+
+static void check(bool ok, const std::string &what)
+{
+    std::cout << (ok ? "  ok    " : "  FAIL  ") << what << std::endl;
+    if (!ok)
+        failures++;
+}
+
+// What tba_api_task puts in the model from a fresh match list
+static DisplayModel polled(const std::string &body, MatchListener &matches)
+{
+    JsonStream json(&matches);
+    json.feed(body.data(), (int)body.size());
+    check(json.finish(), "match list parses");
+    DisplayModel m = {};
+    memcpy(m.matchHistory, matches.history, sizeof(m.matchHistory));
+    m.matchesCompleted = matches.completed;
+    memcpy(m.schedule, matches.schedule, sizeof(m.schedule));
+    m.currentlyPlaying = matches.currentlyPlaying;
+    return m;
+}
+
+static bool entry(const MatchEntry &e, char type, int number, uint16_t color, time_t estTime)
+{
+    return e.type == type && e.number == number && e.color == color && e.estTime == estTime;
+}
+
+static DisplayModel event(time_t start, time_t end)
+{
+    DisplayModel m = {};
+    m.nextEventDate = start;
+    m.nextEventEnd = end;
+    return m;
+}
+
+int main()
+{
+    std::cout << "Around our matches" << std::endl;
+    expect("a minute before", schedule(NOW + 60, NOW + 3600, NOW + 7200), NOW, POLL_MATCH_MS);
+    expect("window opens", schedule(NOW + POLL_MATCH_BEFORE_S, NOW + 3600, 0), NOW, POLL_MATCH_MS);
+    expect("score due", schedule(NOW - 600, NOW + 3600, 0), NOW, POLL_MATCH_MS);
+    expect("window closed", schedule(NOW - POLL_MATCH_AFTER_S, NOW + 3600, 0), NOW, POLL_EVENT_MS);
+    expect("second match's window", schedule(NOW - 3600, NOW + 30, 0), NOW, POLL_MATCH_MS);
+
+    std::cout << "Between our matches" << std::endl;
+    expect("next in an hour", schedule(NOW - 1200, NOW + 3600, NOW + 7200), NOW, POLL_EVENT_MS);
+    expect("wakes for the window", schedule(NOW - 1200, NOW + 200, 0), NOW, (200 - POLL_MATCH_BEFORE_S) * 1000);
+    expect("never under the match rate", schedule(NOW - 1200, NOW + POLL_MATCH_BEFORE_S + 5, 0), NOW, POLL_MATCH_MS);
+    expect("soonest of them", schedule(NOW + 7200, NOW + 200, NOW + 5000), NOW, (200 - POLL_MATCH_BEFORE_S) * 1000);
+
+    std::cout << "Queue distance" << std::endl;
+    DisplayModel queue = schedule(NOW + 7200, NOW + 9000, NOW + 9900);
+    for (int playing = 1; playing <= 12; playing++)
+    {
+        queue.currentlyPlaying = playing;
+        int ahead = 10 - playing;
+        std::string what = "field on " + std::to_string(playing) + ", ours is 10";
+        expect(what.c_str(), queue, NOW, ahead >= 0 && ahead <= POLL_MATCH_QUEUE ? POLL_MATCH_MS : POLL_EVENT_MS);
+    }
+    queue.currentlyPlaying = 19; // Past the first, two away from the second
+    expect("field on 19, ours is 20", queue, NOW, POLL_MATCH_MS);
+    queue.currentlyPlaying = 0;
+    expect("field unknown", queue, NOW, POLL_EVENT_MS);
+
+    std::cout << "No matches ahead" << std::endl;
+    expect("no schedule at all", DisplayModel{}, NOW, POLL_DEFAULT_MS);
+    expect("event in ten days", event(NOW + 10 * DAY, NOW + 12 * DAY), NOW, POLL_IDLE_MS);
+    expect("event tomorrow", event(NOW + 12 * 60 * 60, NOW + 2 * DAY), NOW, POLL_DEFAULT_MS);
+    expect("first day of the event", event(NOW - 9 * 60 * 60, NOW + DAY), NOW, POLL_EVENT_MS);
+    expect("last day of the event", event(NOW - 2 * DAY, NOW - 9 * 60 * 60), NOW, POLL_EVENT_MS);
+    expect("one day event, today", event(NOW - 9 * 60 * 60, NOW - 9 * 60 * 60), NOW, POLL_EVENT_MS);
+    expect("event over", event(NOW - 4 * DAY, NOW - 2 * DAY), NOW, POLL_DEFAULT_MS);
+    expect("our matches over", schedule(NOW - 9000, NOW - 5000, NOW - 1200), NOW, POLL_EVENT_MS);
+    DisplayModel after = schedule(NOW - 9000, NOW - 5000, NOW - 1200);
+    after.nextEventDate = NOW + 40 * DAY; // Event's over, the next one's picked up
+    after.nextEventEnd = NOW + 42 * DAY;
+    expect("our matches over, next event weeks away", after, NOW, POLL_IDLE_MS);
+
+    std::cout << "Clock not set" << std::endl;
+    expect("matches known", schedule(NOW + 60, NOW + 3600, 0, 9), 0, POLL_DEFAULT_MS);
+    expect("event known", event(NOW + 10 * DAY, NOW + 12 * DAY), 0, POLL_DEFAULT_MS);
+
+    std::cout << "Schedule from TBA" << std::endl;
+    std::ifstream in("tba_payloads/team_matches.json", std::ios::binary);
+    std::stringstream text;
+    text << in.rdbuf();
+    check(!text.str().empty(), "read tba_payloads/team_matches.json (run from test/)");
+    MatchListener teamMatches;
+    DisplayModel fromTba = polled(text.str(), teamMatches);
+    check(fromTba.matchesCompleted == 12, "12 played matches in the history");
+    check(entry(fromTba.schedule[0], 'Q', 75, 0xF800, 1777580762) && entry(fromTba.schedule[1], 'Q', 81, 0xF800, 1777583240) &&
+              fromTba.schedule[2].number == 0,
+          "unplayed Q75 and Q81 on the schedule, red, at the predicted times");
+    check(fromTba.currentlyPlaying == 69, "field past our last played match, Q69");
+    fromTba.nextEventDate = 1777550400 - 9 * 60 * 60;
+    fromTba.nextEventEnd = fromTba.nextEventDate + DAY;
+    expect("an hour before Q75", fromTba, 1777580762 - 3600, POLL_EVENT_MS);
+    expect("a minute before Q75", fromTba, 1777580762 - 60, POLL_MATCH_MS);
+    expect("Q75 scored, Q81 an hour off", fromTba, 1777580762 + POLL_MATCH_AFTER_S, POLL_EVENT_MS);
+
+    // Out of order, us on blue, no prediction yet for some, playoffs, a fourth one to drop
+    MatchListener made;
+    DisplayModel ours = polled(
+        "[{\"comp_level\": \"sf\", \"set_number\": 3, \"match_number\": 1, \"time\": 1774120000, \"predicted_time\": null,"
+        "  \"alliances\": {\"red\": {\"score\": -1, \"team_keys\": [\"frc1\"]}, \"blue\": {\"score\": -1, \"team_keys\": [\"frc5459\"]}}},"
+        " {\"comp_level\": \"qm\", \"set_number\": 1, \"match_number\": 30, \"time\": 1774110000, \"predicted_time\": 1774110300,"
+        "  \"alliances\": {\"red\": {\"score\": -1, \"team_keys\": [\"frc5459\"]}, \"blue\": {\"score\": -1, \"team_keys\": [\"frc2\"]}}},"
+        " {\"comp_level\": \"qm\", \"set_number\": 1, \"match_number\": 22, \"time\": 1774105000, \"predicted_time\": 1774104800,"
+        "  \"alliances\": {\"red\": {\"score\": -1, \"team_keys\": [\"frc3\"]}, \"blue\": {\"score\": -1, \"team_keys\": [\"frc5459\"]}}},"
+        " {\"comp_level\": \"f\", \"set_number\": 1, \"match_number\": 2, \"time\": 1774130000, \"predicted_time\": null,"
+        "  \"alliances\": {\"red\": {\"score\": -1, \"team_keys\": [\"frc5459\"]}, \"blue\": {\"score\": -1, \"team_keys\": [\"frc4\"]}}},"
+        " {\"comp_level\": \"qm\", \"set_number\": 1, \"match_number\": 14, \"time\": 1774099000, \"predicted_time\": 1774099100,"
+        "  \"alliances\": {\"red\": {\"score\": 88, \"team_keys\": [\"frc5459\"]}, \"blue\": {\"score\": 70, \"team_keys\": [\"frc5\"]}}}]",
+        made);
+    check(entry(ours.schedule[0], 'Q', 22, 0x001F, 1774104800) && entry(ours.schedule[1], 'Q', 30, 0xF800, 1774110300) &&
+              entry(ours.schedule[2], 'P', 3, 0x001F, 1774120000),
+          "soonest three in order, blue when we're blue, the scheduled time without a prediction");
+    check(ours.matchesCompleted == 1 && ours.matchHistory[0].matchNum == 14 && ours.currentlyPlaying == 14,
+          "Q14 played, the field past it");
+
+    // Failures: each step is the one before doubled, capped, and every delay lands in its top half
+    std::cout << "Backoff" << std::endl;
+    uint32_t step = POLL_RETRY_MS;
+    for (int f = 1; f <= 12; f++)
+    {
+        uint32_t lo = UINT32_MAX, hi = 0;
+        uint32_t random = 1;
+        for (int i = 0; i < 100000; i++)
+        {
+            random = random * 1664525u + 1013904223u;
+            // During a match window too: failing trumps everything
+            uint32_t delay = nextPoll(schedule(NOW + 60, 0, 0, 9), NOW, f, random).delayMs;
+            lo = delay < lo ? delay : lo;
+            hi = delay > hi ? delay : hi;
+        }
+        for (uint32_t random : {0u, 1u, UINT32_MAX})
+        {
+            uint32_t delay = nextPoll(DisplayModel{}, NOW, f, random).delayMs;
+            lo = delay < lo ? delay : lo;
+            hi = delay > hi ? delay : hi;
+        }
+
+        bool ok = lo >= step / 2 && hi <= step && hi <= POLL_RETRY_MAX_MS && hi - lo > step / 2 * 9 / 10;
+        std::cout << (ok ? "  ok    " : "  FAIL  ") << f << " failures: " << lo << ".." << hi << "ms of a "
+                  << step << "ms step" << std::endl;
+        if (!ok)
+            failures++;
+        step = step * 2 > POLL_RETRY_MAX_MS ? POLL_RETRY_MAX_MS : step * 2;
+    }
+
+    std::cout << (failures ? "FAILED" : "PASSED") << std::endl;
+    return failures ? 1 : 0;
+}
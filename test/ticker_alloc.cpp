@@ -0,0 +1,117 @@
+#include <iostream>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+
+#include "ticker_store.h"
+#include "display_layers.h"
+#include "FreeSans9pt7b.h"
+
+// TickerStore (main/ticker_store.h) against Adafruit_GFX: the measured widths match getTextBounds(), draw() puts
+// down the same pixels as print() at every scroll position, and neither formatting nor drawing allocates.
+//
+// g++ -I../main -I../components/adafruit_gfx -I../components/adafruit_gfx/Fonts -o ticker_alloc.exe ticker_alloc.cpp
+//     ../main/ticker_store.cpp ../main/display_layers.cpp ../components/adafruit_gfx/Adafruit_GFX.cpp ../components/adafruit_gfx/Print.cpp
+
+static long allocations = 0;
+
+void *operator new(size_t n) { allocations++; void *p = malloc(n ? n : 1); if (!p) throw std::bad_alloc(); return p; }
+void *operator new[](size_t n) { allocations++; void *p = malloc(n ? n : 1); if (!p) throw std::bad_alloc(); return p; }
+void operator delete(void *p) noexcept { free(p); }
+void operator delete[](void *p) noexcept { free(p); }
+void operator delete(void *p, size_t) noexcept { free(p); }
+void operator delete[](void *p, size_t) noexcept { free(p); }
+
+// What refreshTicker() does when the countdown changes
+static bool fill(TickerStore &t, int days)
+{
+    t.clear();
+    bool ok = t.add("%s", "IPSWICH TIGERS 5459");
+    ok = t.add("T-%d DAYS UNTIL %s COMP", days, "Hartford") && ok;
+    ok = t.add("%s", "ROBOTICS TEAM 5459") && ok;
+    return ok;
+}
+
+int main()
+{
+    const LayerRect clip = {0, 45, 129, 19}; // The ticker layer
+    int failures = 0;
+
+    TickerStore ticker(&FreeSans9pt7b);
+    LayerCanvas expected(clip), actual(clip);
+    expected.setFont(&FreeSans9pt7b);
+    actual.setFont(&FreeSans9pt7b);
+
+    // Steady state: the store is rebuilt every time round the messages, so formatting can't allocate either
+    long before = allocations;
+    for (int days = 40; days >= 0; days--)
+    {
+        if (!fill(ticker, days))
+        {
+            std::cout << "FAIL: messages didn't fit at " << days << " days" << std::endl;
+            failures++;
+        }
+    }
+    if (allocations != before)
+    {
+        std::cout << "FAIL: add() allocated " << allocations - before << " times" << std::endl;
+        failures++;
+    }
+
+    for (int i = 0; i < ticker.size(); i++)
+    {
+        int16_t x1, y1;
+        uint16_t w, h;
+        expected.getTextBounds(ticker[i].text, 0, 0, &x1, &y1, &w, &h);
+        if (w != ticker[i].width)
+        {
+            std::cout << "FAIL: \"" << ticker[i].text << "\" measured " << ticker[i].width << ", getTextBounds " << w << std::endl;
+            failures++;
+        }
+    }
+
+    int positions = 0;
+    long drawAllocations = 0;
+    for (int x = 130; x > -300; x--)
+    {
+        for (int i = 0; i < ticker.size(); i++)
+        {
+            expected.fillScreen(0);
+            expected.setTextColor(0xFFFF);
+            expected.setCursor(x, 60);
+            expected.print(ticker[i].text);
+
+            actual.fillScreen(0);
+            before = allocations;
+            ticker.draw(&actual, i, x, 60, 0xFFFF, clip.x, clip.x + clip.w);
+            drawAllocations += allocations - before;
+
+            if (memcmp(expected.getBuffer(), actual.getBuffer(), clip.w * clip.h * 2) != 0)
+            {
+                std::cout << "FAIL: message " << i << " differs from print() at x " << x << std::endl;
+                failures++;
+            }
+            positions++;
+        }
+    }
+    if (drawAllocations != 0)
+    {
+        std::cout << "FAIL: draw() allocated " << drawAllocations << " times" << std::endl;
+        failures++;
+    }
+
+    // Too much for the arena is refused rather than overrunning it
+    char longText[TICKER_ARENA_SIZE + 1]; // One more than fits with its terminator
+    memset(longText, 'W', sizeof(longText) - 1);
+    longText[sizeof(longText) - 1] = 0;
+    ticker.clear();
+    if (ticker.add("%s", longText) || ticker.size() != 0)
+    {
+        std::cout << "FAIL: a message bigger than the arena was accepted" << std::endl;
+        failures++;
+    }
+
+    std::cout << positions << " positions drawn, " << drawAllocations << " allocations" << std::endl;
+    std::cout << (failures ? "FAILED" : "PASSED") << std::endl;
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,264 @@
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <algorithm>
+#include <random>
+#include <cstring>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <unistd.h>
+#include <openssl/hmac.h>
+
+#include "tba_webhook.h"
+#include "esp_http_server.h"
+#include "esp_timer.h"
+#include "config.h"
+
+// The webhook server (main/tba_webhook.cpp) end to end on loopback: recorded TBA pushes (tba_payloads/webhooks/) are
+// signed and POSTed in random sized pieces to webhook_start()'s server, and the updates it queues are applied to a
+// model the way tba_wait() does. Checks the responses, forged and tampered bodies, what ends up in the history and
+// schedule (a playoff set and the qualification match with the same number kept apart), then times arrival to
+// applied over a few hundred pushes. Run from this directory.
+//
+// host/ stands in for esp_http_server, FreeRTOS queues, esp_timer and mbedtls (over OpenSSL).
+//
+// g++ -O2 -Ihost -I../main -o webhook_replay.exe webhook_replay.cpp ../main/tba_webhook.cpp ../main/json_stream.cpp
+//     host/esp_http_server.cpp host/freertos.cpp host/mbedtls_md.cpp -lcrypto -pthread
+
+static const int TIMING_POSTS = 400;
+
+static int failures = 0;
+
+static void check(bool ok, const std::string &what)
+{
+    std::cout << (ok ? "  ok    " : "  FAIL  ") << what << std::endl;
+    if (!ok)
+        failures++;
+}
+
+static std::string recorded(const char *name)
+{
+    std::ifstream in(std::string("tba_payloads/webhooks/") + name, std::ios::binary);
+    std::stringstream body;
+    body << in.rdbuf();
+    if (body.str().empty())
+        check(false, std::string("couldn't read tba_payloads/webhooks/") + name + " (run from test/)");
+    return body.str();
+}
+
+// X-TBA-HMAC: hex HMAC-SHA256 of the body, upper case to check the comparison doesn't mind
+static std::string sign(const std::string &body, const char *secret)
+{
+    unsigned char digest[32];
+    unsigned len;
+    HMAC(EVP_sha256(), secret, strlen(secret), (const unsigned char *)body.data(), body.size(), digest, &len);
+    char hex[65];
+    for (int i = 0; i < 32; i++)
+        snprintf(&hex[i * 2], 3, "%02X", digest[i]);
+    return hex;
+}
+
+// --- TBA's end ---
+class Pusher
+{
+public:
+    explicit Pusher(int port) : random(5459)
+    {
+        sock = socket(AF_INET, SOCK_STREAM, 0);
+        sockaddr_in addr = {};
+        addr.sin_family = AF_INET;
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        addr.sin_port = htons(port);
+        int one = 1;
+        setsockopt(sock, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+        if (connect(sock, (sockaddr *)&addr, sizeof(addr)) != 0)
+            check(false, "connect to the webhook server");
+    }
+
+    ~Pusher() { close(sock); }
+
+    // POSTs body in pieces of 1..700 bytes, returning the HTTP status
+    int post(const std::string &body, const std::string &hmac, const char *path = WEBHOOK_PATH)
+    {
+        std::string head = std::string("POST ") + path + " HTTP/1.1\r\nHost: tiger-board.local\r\nContent-Type: application/json\r\n" +
+                           "X-TBA-Version: 1\r\nX-TBA-HMAC: " + hmac + "\r\nContent-Length: " + std::to_string(body.size()) + "\r\n\r\n";
+        sendAll(head);
+        std::uniform_int_distribution<size_t> piece(1, 700);
+        for (size_t at = 0; at < body.size();)
+        {
+            size_t n = std::min(piece(random), body.size() - at);
+            sendAll(body.substr(at, n));
+            at += n;
+        }
+
+        // Status line, headers, then Content-Length of body
+        std::string response;
+        char buf[512];
+        size_t headEnd;
+        while ((headEnd = response.find("\r\n\r\n")) == std::string::npos)
+        {
+            ssize_t n = recv(sock, buf, sizeof(buf), 0);
+            if (n <= 0)
+                return 0;
+            response.append(buf, n);
+        }
+        size_t length = 0;
+        size_t at = response.find("Content-Length: ");
+        if (at != std::string::npos && at < headEnd)
+            length = atoi(response.c_str() + at + 16);
+        while (response.size() < headEnd + 4 + length)
+        {
+            ssize_t n = recv(sock, buf, sizeof(buf), 0);
+            if (n <= 0)
+                return 0;
+            response.append(buf, n);
+        }
+        return atoi(response.c_str() + response.find(' ') + 1);
+    }
+
+private:
+    int sock;
+    std::mt19937 random;
+
+    void sendAll(const std::string &data)
+    {
+        for (size_t at = 0; at < data.size();)
+        {
+            ssize_t n = send(sock, data.data() + at, data.size() - at, MSG_NOSIGNAL);
+            if (n <= 0)
+                return;
+            at += n;
+        }
+    }
+};
+
+// --- The board's end, as tba_wait() ---
+struct Applier
+{
+    DisplayModel model = {};
+    int received = 0;
+    int applied = 0;
+    std::vector<int64_t> latencyUs;
+
+    void run(QueueHandle_t queue, const std::atomic<bool> &pusherDone)
+    {
+        WebhookUpdate update;
+        while (true)
+        {
+            if (xQueueReceive(queue, &update, pdMS_TO_TICKS(20)) != pdTRUE)
+            {
+                if (pusherDone)
+                    return;
+                continue;
+            }
+            received++;
+            if (webhook_apply(model, update))
+                applied++;
+            latencyUs.push_back(esp_timer_get_time() - update.receivedUs);
+        }
+    }
+};
+
+static bool has_score(const DisplayModel &m, char type, int number, int score)
+{
+    for (int i = 0; i < m.matchesCompleted; i++)
+        if (m.matchHistory[i].type == type && m.matchHistory[i].matchNum == number)
+            return m.matchHistory[i].totalScore == score;
+    return false;
+}
+
+int main()
+{
+    QueueHandle_t queue = xQueueCreate(WEBHOOK_QUEUE, sizeof(WebhookUpdate));
+    if (!webhook_start(queue))
+    {
+        std::cout << "FAILED" << std::endl;
+        return 1;
+    }
+    const char *secret = TBA_WEBHOOK_SECRET;
+
+    // What polling had before the pushes: Q3 played, Q12 and Q20 to come
+    Applier board;
+    board.model.matchHistory[0] = {3, 0, 0, 0, 0, 0, 50, false, false, 'Q'};
+    board.model.matchesCompleted = 1;
+    board.model.schedule[0] = {'Q', 12, 0xF800, 1774099800};
+    board.model.schedule[1] = {'Q', 20, 0x001F, 1774108800};
+
+    std::cout << "Replay" << std::endl;
+    std::atomic<bool> done(false);
+    std::thread applier([&] { board.run(queue, done); });
+    {
+        Pusher tba(httpd_host_port());
+        auto push = [&](const char *name, int expected, const char *what) {
+            std::string body = recorded(name);
+            check(tba.post(body, sign(body, secret)) == expected, what);
+        };
+
+        push("upcoming_qm14.json", 200, "upcoming Q14 accepted");
+        push("score_qm12.json", 200, "Q12 score accepted");
+        push("score_qm13_other.json", 200, "someone else's score accepted (and ignored)");
+
+        std::string q12 = recorded("score_qm12.json");
+        check(tba.post(q12, sign(q12, "not-our-secret")) == 401, "signed with another secret: 401");
+        std::string tampered = q12;
+        tampered.replace(tampered.find("\"score\": 131"), 12, "\"score\": 181");
+        check(tba.post(tampered, sign(q12, secret)) == 401, "score changed after signing: 401");
+        check(tba.post(q12, "") == 401, "unsigned: 401");
+        check(tba.post("{\"message_type\": ", sign("{\"message_type\": ", secret)) == 401, "signed but cut short: 401");
+        check(tba.post(q12, sign(q12, secret), "/elsewhere") == 404, "other paths: 404");
+
+        push("verification.json", 200, "verification accepted");
+        push("ping.json", 200, "ping accepted");
+        push("score_qm14.json", 200, "Q14 score accepted");
+        push("upcoming_sf3m1.json", 200, "upcoming playoff set 3 accepted");
+        push("score_sf3m1.json", 200, "playoff set 3 score accepted");
+        push("score_f1m2.json", 200, "final 2 score accepted");
+        push("score_qm12.json", 200, "Q12 score again accepted");
+    }
+    done = true;
+    applier.join();
+
+    const DisplayModel &m = board.model;
+    check(board.received == 7, "7 updates queued, " + std::to_string(board.received) + " were");
+    check(board.applied == 6, "6 changed the model, " + std::to_string(board.applied) + " did");
+    check(m.matchesCompleted == 5, "5 matches in the history");
+    check(has_score(m, 'Q', 3, 50), "polled Q3 left alone by playoff set 3");
+    check(has_score(m, 'Q', 12, 131), "Q12 red score");
+    check(has_score(m, 'Q', 14, 77), "Q14 red score (we were blue)");
+    check(has_score(m, 'P', 3, 141), "playoff set 3 red score");
+    check(has_score(m, 'P', 2, 160), "final 2 red score");
+    check(m.schedule[0].type == 'Q' && m.schedule[0].number == 20 && m.schedule[1].number == 0,
+          "played matches off the schedule, Q20 left");
+
+    // --- Apply latency ---
+    std::cout << "Timing" << std::endl;
+    Applier timed;
+    done = false;
+    std::thread timing([&] { timed.run(queue, done); });
+    {
+        Pusher tba(httpd_host_port());
+        std::string bodies[2] = {recorded("score_qm12.json"), recorded("upcoming_qm14.json")};
+        std::string hmacs[2] = {sign(bodies[0], secret), sign(bodies[1], secret)};
+        for (int i = 0; i < TIMING_POSTS; i++)
+            tba.post(bodies[i & 1], hmacs[i & 1]);
+    }
+    done = true;
+    timing.join();
+
+    std::vector<int64_t> &us = timed.latencyUs;
+    check((int)us.size() == TIMING_POSTS, std::to_string(us.size()) + " of " + std::to_string(TIMING_POSTS) + " applied");
+    if (!us.empty())
+    {
+        std::sort(us.begin(), us.end());
+        std::cout << "  arrival to applied, us: min " << us.front() << ", median " << us[us.size() / 2] << ", 99% "
+                  << us[us.size() * 99 / 100] << ", max " << us.back() << std::endl;
+    }
+
+    std::cout << (failures ? "FAILED" : "PASSED") << std::endl;
+    return failures ? 1 : 0;
+}